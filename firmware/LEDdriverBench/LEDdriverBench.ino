@@ -0,0 +1,66 @@
+// Замер времени вывода одного кадра драйверами ленты, которые можно выбрать
+// настройкой LED_DRIVER в прошивке: FastLED (с лимитом тока и без) и Adafruit_NeoPixel.
+// Для NeoPixel отдельно меряется перенос leds[] в буфер библиотеки и сама передача.
+// Лента подключается как в прошивке, результат выводится в порт (9600)
+
+#define NUM_LEDS 60
+#define LED_PIN 12
+#define CURRENT_LIMIT 3000
+#define BRIGHTNESS 200
+#define FRAMES 100
+
+#define FASTLED_ALLOW_INTERRUPTS 1
+#include "FastLED.h"
+#include <Adafruit_NeoPixel.h>
+
+CRGB leds[NUM_LEDS];
+Adafruit_NeoPixel strip(NUM_LEDS, LED_PIN, NEO_GRB + NEO_KHZ800);
+byte hue;
+
+void setup() {
+  Serial.begin(9600);
+  FastLED.addLeds<WS2811, LED_PIN, GRB>(leds, NUM_LEDS).setCorrection( TypicalLEDStrip );
+  FastLED.setBrightness(BRIGHTNESS);
+  strip.begin();
+  strip.setBrightness(BRIGHTNESS);
+}
+
+// одинаковое содержимое leds[] для всех драйверов
+void frame() {
+  fill_rainbow(leds, NUM_LEDS, hue++, 255 / NUM_LEDS);
+}
+
+void printResult(const __FlashStringHelper *name, unsigned long us) {
+  Serial.print(name);
+  Serial.print(us / FRAMES);
+  Serial.println(F(" мкс/кадр"));
+}
+
+void loop() {
+  unsigned long start, convert = 0;
+
+  FastLED.setMaxPowerInVoltsAndMilliamps(5, 100000);   // лимит не срабатывает
+  frame();
+  start = micros();
+  for (int f = 0; f < FRAMES; f++) FastLED.show();
+  printResult(F("FastLED:                 "), micros() - start);
+
+  FastLED.setMaxPowerInVoltsAndMilliamps(5, CURRENT_LIMIT);
+  start = micros();
+  for (int f = 0; f < FRAMES; f++) FastLED.show();
+  printResult(F("FastLED + лимит тока:    "), micros() - start);
+
+  start = micros();
+  for (int f = 0; f < FRAMES; f++) {
+    unsigned long t = micros();
+    for (int i = 0; i < NUM_LEDS; i++)
+      strip.setPixelColor(i, leds[i].r, leds[i].g, leds[i].b);
+    convert += micros() - t;
+    strip.show();
+  }
+  printResult(F("NeoPixel:                "), micros() - start);
+  printResult(F("  из них перенос leds[]: "), convert);
+
+  Serial.println();
+  delay(2000);
+}
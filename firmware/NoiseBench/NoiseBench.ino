@@ -0,0 +1,88 @@
+// Замер времени расчёта кадра шумового режима (9 режим прошивки) для разной длины ленты:
+// полный расчёт двух октав шума на каждый светодиод против инкрементального
+// (кэш крупной октавы + мелкая октава в опорных точках через NOISE_STEP с интерполяцией).
+// Лента не нужна, результат выводится в порт (9600). Оценка максимальной длины для 100 FPS
+// учитывает и передачу на ленту WS2812 (~30 мкс на светодиод)
+
+#define MAX_LEDS 300       // больше не влезает в RAM Uno вместе с буфером полного расчёта
+#define NOISE_STEP 8
+#define FRAMES 20
+#define FRAME_US 10000      // 100 FPS
+#define SHOW_US_PER_LED 30
+
+#include "FastLED.h"
+
+CRGB leds[MAX_LEDS];
+byte noise_base[MAX_LEDS / NOISE_STEP + 2];
+uint16_t noise_t;
+byte full_val[MAX_LEDS];
+const int lengths[] = {60, 120, 200, 300};
+
+// полный расчёт: 2 октавы на каждый светодиод каждый кадр
+void frameFull(int num) {
+  byte *val = full_val;
+  memset(val, 0, num);
+  noise_t += 3;
+  for (int i = 0; i < num; i += 200)   // fill_raw_noise принимает до 255 точек
+    fill_raw_noise16into8(val + i, min(num - i, 200), 2, (uint32_t)i * 1000, 1000, (uint32_t)noise_t << 7);
+  for (int i = 0; i < num; i++) ((CHSV *)leds)[i] = CHSV(val[i], 255, val[i]);
+  hsv2rgb_rainbow((CHSV *)leds, leds, num);
+}
+
+// инкрементальный расчёт как в прошивке, крупная октава пересчитывается раз в 8 кадров
+void frameIncremental(int num, byte frame) {
+  byte points = (num + NOISE_STEP - 1) / NOISE_STEP + 1;
+  if ((frame & 7) == 0) {
+    memset(noise_base, 0, points);
+    fill_raw_noise16into8(noise_base, points, 1, 0, NOISE_STEP * 1000, (uint32_t)noise_t << 7);
+  }
+  byte val[MAX_LEDS / NOISE_STEP + 2];
+  noise_t += 3;
+  memset(val, 0, points);
+  fill_raw_noise8(val, points, 1, 0, NOISE_STEP * 12, noise_t);
+  for (byte p = 0; p < points; p++) val[p] = avg8(noise_base[p], val[p]);
+  for (int i = 0; i < num; i++) {
+    byte p = i / NOISE_STEP;
+    byte frac = (i % NOISE_STEP) * (256 / NOISE_STEP);
+    ((CHSV *)leds)[i] = CHSV(lerp8by8(noise_base[p], noise_base[p + 1], frac), 255,
+                             lerp8by8(val[p], val[p + 1], frac));
+  }
+  hsv2rgb_rainbow((CHSV *)leds, leds, num);
+}
+
+// сколько светодиодов укладывается в кадр 100 FPS вместе с выводом на ленту
+long maxLeds(unsigned long us, int num) {
+  return (long)FRAME_US * num / (us + (long)SHOW_US_PER_LED * num);
+}
+
+void printResult(const __FlashStringHelper *name, unsigned long us, int num) {
+  Serial.print(name);
+  Serial.print(us);
+  Serial.print(F(" мкс/кадр, "));
+  Serial.print(us * 1000 / num);
+  Serial.print(F(" нс/светодиод, до "));
+  Serial.print(maxLeds(us, num));
+  Serial.println(F(" светодиодов при 100 FPS"));
+}
+
+void setup() {
+  Serial.begin(9600);
+}
+
+void loop() {
+  for (byte n = 0; n < sizeof(lengths) / sizeof(int); n++) {
+    int num = lengths[n];
+    Serial.print(num);
+    Serial.println(F(" светодиодов:"));
+
+    unsigned long start = micros();
+    for (byte f = 0; f < FRAMES; f++) frameFull(num);
+    printResult(F("  полный:          "), (micros() - start) / FRAMES, num);
+
+    start = micros();
+    for (byte f = 0; f < FRAMES; f++) frameIncremental(num, f);
+    printResult(F("  инкрементальный: "), (micros() - start) / FRAMES, num);
+  }
+  Serial.println();
+  delay(2000);
+}
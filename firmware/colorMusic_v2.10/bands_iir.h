@@ -0,0 +1,56 @@
+// потоковый анализатор трёх полос: фильтры переменного состояния (Чемберлин), 2 умножения на выборку.
+// Низкие - полоса первого фильтра, средние - полоса второго, высокие - его ФВЧ. Частоты примерно
+// соответствуют бинам FHT 2-5, 6-10 и 11-31 (fht_bands при ADC_OVERSAMPLE 1). Фильтры считаются,
+// пока АЦП преобразует следующую выборку, поэтому частота выборок - 13 тактов АЦП (делитель 32, 26 мкс).
+// Отдельный файл, чтобы его можно было проверить на компьютере (extras/test)
+#ifndef bands_iir_h
+#define bands_iir_h
+
+#define BANDS_FS 38000
+#define BANDS_SAMPLES 64          // выборок за кадр, по времени захвата как FHT
+#define SVF_F(freq) ((int16_t)(2 * sin(PI * (freq) / BANDS_FS) * 16384))
+const int16_t svf_f[2] = {SVF_F(1500), SVF_F(4000)};
+// пик фильтра на входе с запасом <<3 - это амплитуда синуса, а FHT даёт мощность лучшего бина
+// после окна Ханна и деления на FHT_N. Разница в 16 * log2 для тона посреди полосы, замер extras/test
+const byte band_offset[3] = {22, 26, 39};
+int16_t svf_low[2], svf_band[2];
+byte band_level[3], band_prev[3];   // огибающие полос в масштабе fht_log_out (16 * log2)
+
+// 16 * log2(val): старший бит - целая часть, следующие 4 бита - дробная
+byte log2x16(uint16_t val) {
+  if (val == 0) return 0;
+  byte power = 15;
+  while (!(val & 0x8000)) {
+    val <<= 1;
+    power--;
+  }
+  return (power << 4) | ((val >> 11) & 0x0F);
+}
+
+// три полосы фильтрами прямо при захвате, без блочного преобразования
+void analyzeBands() {
+  uint16_t peak[3] = {0, 0, 0};
+  int sample = analogRead(SOUND_R_FREQ);    // выбор входа и первая выборка
+  for (byte i = 0; i < BANDS_SAMPLES; i++) {
+    ADCSRA |= _BV(ADSC);                    // следующее преобразование идёт, пока считаем фильтры
+    int16_t x = (sample - 512) << 3;        // запас точности для целочисленных фильтров
+    int16_t high = 0;
+    for (byte f = 0; f < 2; f++) {
+      svf_low[f] += ((int32_t)svf_f[f] * svf_band[f]) >> 14;
+      high = x - svf_low[f] - svf_band[f];
+      svf_band[f] += ((int32_t)svf_f[f] * high) >> 14;
+      uint16_t this_peak = abs(svf_band[f]);
+      if (this_peak > peak[f]) peak[f] = this_peak;
+    }
+    uint16_t this_peak = abs(high);
+    if (this_peak > peak[2]) peak[2] = this_peak;
+    while (bit_is_set(ADCSRA, ADSC));
+    sample = ADC;
+  }
+  for (byte b = 0; b < 3; b++) {            // на шкалу FHT, тише поправки - ноль
+    byte level = log2x16(peak[b] >> 3);
+    band_level[b] = (level > band_offset[b]) ? level - band_offset[b] : 0;
+  }
+}
+
+#endif
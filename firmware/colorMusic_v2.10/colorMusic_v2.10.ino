@@ -21,6 +21,9 @@
 // ----- настройка ИК пульта
 #define REMOTE_TYPE 1       // 0 - без пульта, 1 - пульт от WAVGAT, 2 - пульт от KEYES, 3 - кастомный пульт
 // система может работать С ЛЮБЫМ ИК ПУЛЬТОМ (практически). Коды для своего пульта можно задать начиная со строки 160 в прошивке. Коды пультов определяются скетчем IRtest_2.0, читай инструкцию
+// или без перепрошивки: тройное нажатие кнопки - режим обучения пульта. Нажимай на пульте по очереди
+// 1 2 3 4 5 6 7 8 9 0 * # OK ВВЕРХ ВНИЗ ВЛЕВО ВПРАВО (количество горящих светодиодов - номер кнопки),
+// клик кнопкой - пропустить кнопку пульта, удержание - закончить обучение. Коды хранятся в EEPROM
 
 // ----- настройки параметров
 #define KEEP_SETTINGS 1     // хранить ВСЕ настройки в энергонезависимой памяти
@@ -29,9 +32,15 @@
 #define SETTINGS_LOG 0      // вывод всех настроек из EEPROM в порт при запуске
 
 // ----- настройки ленты
-#define NUM_LEDS 60        // количество светодиодов (данная версия поддерживает до 410 штук)
+#define NUM_LEDS 60        // количество светодиодов (данная версия поддерживает до 410 штук, с LED_INDEXED - до 1200)
 #define CURRENT_LIMIT 3000  // лимит по току в МИЛЛИАМПЕРАХ, автоматически управляет яркостью (пожалей свой блок питания!) 0 - выключить лимит
 byte BRIGHTNESS = 200;      // яркость по умолчанию (0 - 255)
+#define STRIP_ZIGZAG 0      // лента уложена змейкой рядами по STRIP_ZIGZAG светодиодов (0 - прямая лента), эффекты идут по всем рядам в одну сторону
+                            // при змейке включаются матричные режимы 10-12 (ширина матрицы STRIP_ZIGZAG, высота NUM_LEDS / STRIP_ZIGZAG)
+#define LED_DRIVER 0        // вывод на ленту: 0 - FastLED, 1 - Adafruit_NeoPixel (без CURRENT_LIMIT и коррекции цвета, +3 байта RAM на светодиод), 2 - без ленты (замеры, отладка)
+#define LED_INDEXED 0       // 1 - кадр в индексных цветах: 1 байт RAM на светодиод вместо 3 (для длинных лент), только режимы 0-6 и LED_DRIVER 0 или 2.
+                            // Градиенты режимов 0, 1 и радуга подсветки идут ступенями PAL_STEPS
+#define PALETTE_CACHE (RAMEND > 0x8FF && LED_INDEXED == 0)  // кэш палитры для режимов 0 и 1 (+870 байт RAM), по умолчанию только на платах с RAM больше 2К (Mega)
 
 // ----- пины подключения
 #define SOUND_R A2         // аналоговый пин вход аудио, правый канал
@@ -61,6 +70,11 @@ float RAINBOW_STEP = 5.00;         // шаг изменения цвета ра
 
 // ----- сигнал
 #define MONO 1                    // 1 - только один канал (ПРАВЫЙ!!!!! SOUND_R!!!!!), 0 - два канала
+#define ADC_OVERSAMPLE 1          // передискретизация входа частот для FHT: 2, 4, 8 - во столько раз больше выборок, фильтр CIC и прореживание (полоса 9.6, 4.8, 2.4 кГц), 1 - выкл.
+                                  // спектр тогда в 12-битной шкале и бины FHT во столько же раз ниже по частоте, поэтому только с BANDS_IIR 0
+                                  // (фильтры полос остаются на 38 кГц и 10 битах). После включения перекалибровать шумы (кнопка 0 пульта)
+#define WINDOW_FUNC 0             // окно FHT: 0 - Ханн (лучше разрешение), 1 - Блэкман-Харрис (меньше утечки громкой частоты в соседние полосы), 2 - flat-top (точная амплитуда, самое широкое)
+#define ADC_STREAM 0              // 1 - АЦП без остановки опрашивает по кругу R, L и вход частот (при MONO 0 в 8 режиме у каждой половины свой спектр, +330 байт RAM), 0 - замеры по запросу
 #define EXP 1.4                   // степень усиления сигнала (для более "резкой" работы) (по умолчанию 1.4)
 #define POTENT 0                  // 1 - используем потенциометр, 0 - используется внутренний источник опорного напряжения 1.1 В
 byte EMPTY_BRIGHT = 30;           // яркость "не горящих" светодиодов (0 - 255)
@@ -69,6 +83,7 @@ byte EMPTY_BRIGHT = 30;           // яркость "не горящих" све
 // ----- нижний порог шумов
 uint16_t LOW_PASS = 100;          // нижний порог шумов режим VU, ручная настройка
 uint16_t SPEKTR_LOW_PASS = 40;    // нижний порог шумов режим спектра, ручная настройка
+uint16_t BANDS_LOW_PASS = 40;     // нижний порог шумов фильтров полос (BANDS_IIR): у широких фильтров шум выше, чем у бинов FHT
 #define AUTO_LOW_PASS 0           // разрешить настройку нижнего порога шумов при запуске (по умолч. 0)
 #define EEPROM_LOW_PASS 1         // порог шумов хранится в энергонезависимой памяти (по умолч. 1)
 #define LOW_PASS_ADD 13           // "добавочная" величина к нижнему порогу, для надёжности (режим VU)
@@ -77,10 +92,16 @@ uint16_t SPEKTR_LOW_PASS = 40;    // нижний порог шумов режи
 // ----- режим шкала громкости
 float SMOOTH = 0.3;               // коэффициент плавности анимации VU (по умолчанию 0.5)
 #define MAX_COEF 1.8              // коэффициент громкости (максимальное равно срднему * этот коэф) (по умолчанию 1.8)
+#define VU_ENVELOPE 1             // 1 - шкала по среднеквадратичному (RMS), 0 - по пику
+#define VU_RMS_WINDOW 300         // окно RMS, мс (как у стрелочного VU-метра 300)
+#define VU_PEAK_WINDOW 10         // окно пика, мс (как у PPM 10)
 
 // ----- режим цветомузыки
 float SMOOTH_FREQ = 0.8;          // коэффициент плавности анимации частот (по умолчанию 0.8)
-float MAX_COEF_FREQ = 1.2;        // коэффициент порога для "вспышки" цветомузыки (по умолчанию 1.5)
+float MAX_COEF_FREQ = 1.2;        // порог "вспышки": рост спектра больше среднего на столько средних отклонений (по умолчанию 1.2)
+#define ONSET_HOLD 120            // минимальный интервал между вспышками одной полосы, мс (громкий участок не даёт очередь вспышек)
+#define ONSET_MIN 20              // минимальный рост спектра для вспышки (отсекает шум в тишине)
+#define BANDS_IIR 1               // 1 - низкие/средние/высокие считаются фильтрами прямо при захвате звука, FHT только там, где нужен весь спектр (8 и 10 режимы). 0 - всегда FHT
 #define SMOOTH_STEP 20            // шаг уменьшения яркости в режиме цветомузыки (чем больше, тем быстрее гаснет)
 #define LOW_COLOR HUE_RED         // цвет низких частот
 #define MID_COLOR HUE_GREEN       // цвет средних
@@ -92,6 +113,7 @@ uint16_t STROBE_PERIOD = 140;     // период вспышек, миллисе
 #define STROBE_COLOR HUE_YELLOW   // цвет стробоскопа
 #define STROBE_SAT 0              // насыщенность. Если 0 - цвет будет БЕЛЫЙ при любом цвете (0 - 255)
 byte STROBE_SMOOTH = 200;         // скорость нарастания/угасания вспышки (0 - 255)
+#define STROBE_BEAT 1             // 1 - вспышки подстраиваются под найденный темп музыки, без темпа - по STROBE_PERIOD. 0 - только STROBE_PERIOD
 
 // ----- режим подсветки
 byte LIGHT_COLOR = 0;             // начальный цвет подсветки
@@ -107,6 +129,7 @@ byte RUNNING_SPEED = 11;
 byte HUE_START = 0;
 byte HUE_STEP = 5;
 #define LIGHT_SMOOTH 2
+#define SPEKTR_OCTAVE 0           // 1 - спектр по октавам (fht_mag_octave): 4 октавы плавно растянуты на половину ленты, для длинных лент. 0 - по полосам FHT
 
 /*
   Цвета для HSV
@@ -183,22 +206,113 @@ byte HUE_STEP = 5;
 #define BUTT_HASH   0x38379AD   // #
 #endif
 
+// ----- таблица кнопок пульта -----
+// логические кнопки (порядок обучения). Коды лежат в EEPROM, в оперативке только хэш-таблица индексов
+#define IR_1      0
+#define IR_2      1
+#define IR_3      2
+#define IR_4      3
+#define IR_5      4
+#define IR_6      5
+#define IR_7      6
+#define IR_8      7
+#define IR_9      8
+#define IR_0      9
+#define IR_STAR   10
+#define IR_HASH   11
+#define IR_OK     12
+#define IR_UP     13
+#define IR_DOWN   14
+#define IR_LEFT   15
+#define IR_RIGHT  16
+#define IR_KEYS   17      // количество кнопок пульта
+#define IR_NONE   0xFF    // код не распознан
+#define IR_SLOTS  32      // размер хэш-таблицы (степень двойки, больше IR_KEYS)
+#define IR_EEPROM 104     // адрес кодов пульта в EEPROM (IR_KEYS * 4 байта)
+#define IR_MIN_LENGTH 20  // минимальная длина посылки для обучения (отсекаем повторы и помехи)
+#define IR_LEARN_TIMEOUT 20000  // выход из обучения пульта, если кнопки не нажимают столько мс (выученные коды остаются)
+
 
 // ------------------------------ ДЛЯ РАЗРАБОТЧИКОВ --------------------------------
-#define MODE_AMOUNT 9      // количество режимов
+#if (LED_INDEXED == 1)
+#define MODE_AMOUNT 7      // количество режимов (индексный кадр - только 0-6)
+#elif (STRIP_ZIGZAG > 0)
+#define MODE_AMOUNT 13     // количество режимов (10-12 - матричные)
+#else
+#define MODE_AMOUNT 10     // количество режимов
+#endif
 
-#define STRIPE NUM_LEDS / 5
+// ----- геометрия ленты
+// Эффекты рисуют в логических координатах, физическая раскладка применяется в одном месте:
+// - половины: лента делится пополам от центра, k - номер светодиода половины от центра (0..HALF_LEN-1).
+//   При нечётном NUM_LEDS центральный светодиод общий для обеих половин
+// - сегменты: segStart(s, n) - начало сегмента s из n равных частей (остаток раскидан по сегментам)
+// - змейка STRIP_ZIGZAG: нечётные ряды разворачиваются только при выводе (zigzagPass)
+#define HALF_LEN ((NUM_LEDS + 1) / 2)
+constexpr int halfLeft(int k) { return HALF_LEN - 1 - k; }
+constexpr int halfRight(int k) { return NUM_LEDS - HALF_LEN + k; }
+constexpr int segStart(byte seg, byte segments) { return (long)NUM_LEDS * seg / segments; }
+#define ZIGZAG_W (STRIP_ZIGZAG > 0 ? STRIP_ZIGZAG : 1)
+static_assert(NUM_LEDS % ZIGZAG_W == 0, "NUM_LEDS must be a multiple of STRIP_ZIGZAG");
+constexpr int zigzag(int i) {   // логический индекс -> физический
+  return (STRIP_ZIGZAG > 0 && (i / ZIGZAG_W) % 2) ? i - i % ZIGZAG_W + (ZIGZAG_W - 1 - i % ZIGZAG_W) : i;
+}
+#if (STRIP_ZIGZAG > 0)
+// матрица: x - столбец (0..MATRIX_W-1), y - ряд от начала ленты. Логический индекс y * MATRIX_W + x
+#define MATRIX_W STRIP_ZIGZAG
+#define MATRIX_H (NUM_LEDS / STRIP_ZIGZAG)
+#endif
 float freq_to_stripe = NUM_LEDS / 40; // /2 так как симметрия, и /20 так как 20 частот
 
 #define FHT_N 64         // ширина спектра х2
-#define LOG_OUT 1
+#define LOG_OUT16 1      // спектр в 16 битах (8.8): старший байт - прежняя таблица, младший - доли до следующего шага, плавнее на тихом звуке.
+                         // по времени не дольше 8 бит, +64 байта RAM. 0 - 8 бит
+#define LOG_OUT (1 - LOG_OUT16)
+#define REORDER 0        // окно и перестановка делаются при захвате (fht_input_put), таблица перестановки не нужна
+#define LOG_BANDS 3      // порог, пики и полосы считаются за тот же проход, что и спектр (fht_mag_log_bands)
+#define OCTAVE SPEKTR_OCTAVE
 #include <FHT.h>         // преобразование Хартли
+const uint8_t fht_bands[] = {2, 6, 11, 32};   // низкие 2-5, средние 6-10, высокие 11-31. 0 и 1 зашумленные
+#if (LOG_OUT16 == 1)
+#define LOG_FRAC 8                  // дробных бит в значениях спектра
+#define fht_spektr fht_log_out16
+#else
+#define LOG_FRAC 0
+#define fht_spektr fht_log_out
+#endif
 
 #include <EEPROMex.h>
 
 #define FASTLED_ALLOW_INTERRUPTS 1
-#include "FastLED.h"
+#define FASTLED_AVR_INDEXED LED_INDEXED   // вывод индексного кадра - второй цикл в прошивке, без LED_INDEXED не нужен
+#include "FastLED.h"     // цвета, палитры и математика нужны при любом LED_DRIVER
+// индексный кадр: светодиод - номер ячейки палитры ledsPal, в RGB он переводится при выводе на ленту.
+// Режим кладёт в палитру свои цвета на кадр (ledsColor) и заливает ими ленту. Без LED_INDEXED номер ячейки не используется
+#define PAL_BLACK 0       // ledsClear() обнуляет кадр - чёрный
+#define PAL_EMPTY 1       // "не горящие" светодиоды
+#define PAL_LOW 2
+#define PAL_MID 3
+#define PAL_HIGH 4
+#define PAL_FILL 5        // заливка одним цветом: стробоскоп, подсветка, обучение пульта
+#define PAL_GRAD 6        // первая ступень градиента
+#if (LED_INDEXED == 1)
+#if (LED_DRIVER == 1)
+#error "LED_INDEXED работает только с LED_DRIVER 0 или 2"
+#endif
+#define PAL_STEPS 32      // ступеней градиента, 3 байта RAM на ступень (степень двойки, до 128)
+static_assert((PAL_STEPS & (PAL_STEPS - 1)) == 0 && PAL_STEPS <= 128, "PAL_STEPS must be a power of two up to 128");
+typedef byte led_t;
+led_t leds[NUM_LEDS];
+CRGB ledsPal[PAL_GRAD + PAL_STEPS];
+#else
+typedef CRGB led_t;
 CRGB leds[NUM_LEDS];
+#endif
+
+#if (LED_DRIVER == 1)
+#include <Adafruit_NeoPixel.h>
+Adafruit_NeoPixel strip(NUM_LEDS, LED_PIN, NEO_GRB + NEO_KHZ800);
+#endif
 
 #include "GyverButton.h"
 GButton butt1(BTN_PIN);
@@ -207,6 +321,19 @@ GButton butt1(BTN_PIN);
 CHashIR IRLremote;
 uint32_t IRdata;
 
+#if REMOTE_TYPE != 0
+byte ir_slots[IR_SLOTS];      // открытая адресация: индекс логической кнопки или IR_NONE
+uint32_t ir_codes[IR_KEYS];   // копия кодов из EEPROM, чтобы не читать её на каждый опрос
+int8_t ir_learn = -1;         // номер обучаемой кнопки, -1 - обучение выключено
+uint32_t ir_learn_timer;      // время последнего шага обучения
+
+// коды по умолчанию, записываются в EEPROM при первом запуске
+const uint32_t ir_default[IR_KEYS] PROGMEM = {
+  BUTT_1, BUTT_2, BUTT_3, BUTT_4, BUTT_5, BUTT_6, BUTT_7, BUTT_8, BUTT_9, BUTT_0,
+  BUTT_STAR, BUTT_HASH, BUTT_OK, BUTT_UP, BUTT_DOWN, BUTT_LEFT, BUTT_RIGHT
+};
+#endif
+
 // градиент-палитра от зелёного к красному
 DEFINE_GRADIENT_PALETTE(soundlevel_gp) {
   0,    0,    255,  0,  // green
@@ -216,6 +343,25 @@ DEFINE_GRADIENT_PALETTE(soundlevel_gp) {
   255,  255,  0,    0   // red
 };
 CRGBPalette32 myPal = soundlevel_gp;
+#if (PALETTE_CACHE == 1)
+CRGBPaletteCache palCache;    // палитра текущего режима, развёрнутая в 256 цветов
+#define PALETTE_COLOR(pal, i) palCache[(byte)(int)(i)]    // цвет из кэша - одно чтение из массива
+#else
+#define PALETTE_COLOR(pal, i) ColorFromPalette(pal, (byte)(int)(i))
+#endif
+// градиент режимов 0 и 1: gradPalette - один раз на кадр, GRAD_COLOR - цвет светодиода.
+// В индексном кадре палитра раскладывается по ступеням в ledsPal, светодиод получает номер ступени
+#if (LED_INDEXED == 1)
+#define GRAD_STEP (256 / PAL_STEPS)
+#define gradPalette(pal) for (byte j = 0; j < PAL_STEPS; j++) ledsPal[PAL_GRAD + j] = ColorFromPalette(pal, j * GRAD_STEP + GRAD_STEP / 2)
+#define GRAD_COLOR(pal, i) (PAL_GRAD + (byte)(int)(i) / GRAD_STEP)
+#elif (PALETTE_CACHE == 1)
+#define gradPalette(pal) palCache.update(pal)    // разворачивается заново только при смене палитры
+#define GRAD_COLOR(pal, i) PALETTE_COLOR(pal, i)
+#else
+#define gradPalette(pal)
+#define GRAD_COLOR(pal, i) PALETTE_COLOR(pal, i)
+#endif
 
 int Rlenght, Llenght;
 float RsoundLevel, RsoundLevel_f;
@@ -223,39 +369,195 @@ float LsoundLevel, LsoundLevel_f;
 
 float averageLevel = 50;
 int maxLevel = 100;
-int MAX_CH = NUM_LEDS / 2;
 int hue;
 unsigned long main_timer, hue_timer, strobe_timer, running_timer, color_timer, rainbow_timer, eeprom_timer;
 float averK = 0.006;
-byte count;
-float index = (float)255 / MAX_CH;   // коэффициент перевода для палитры
+float index = (float)255 / HALF_LEN;   // коэффициент перевода для палитры
 boolean lowFlag;
 byte low_pass;
-int RcurrentLevel, LcurrentLevel;
-int colorMusic[3];
-float colorMusic_f[3], colorMusic_aver[3];
 boolean colorMusicFlash[3], strobeUp_flag, strobeDwn_flag;
 byte this_mode = MODE;
 int thisBright[3], strobe_bright = 0;
-unsigned int light_time = STROBE_PERIOD * STROBE_DUTY / 100;
 volatile boolean ir_flag;
 boolean settings_mode, ONstate = true;
 int8_t freq_strobe_mode, light_mode;
-int freq_max;
+uint16_t freq_max;
 float freq_max_f, rainbow_steps;
-int freq_f[32];
+fht_log_t freq_f[FHT_N / 2];   // спектр с плавным спадом, по номеру полосы FHT
+#if (SPEKTR_OCTAVE == 1)
+#define OCT_FIRST 2                 // октавы 0 и 1 - полосы 0 и 1 FHT, зашумленные
+#define OCT_NUM (LOG_N - OCT_FIRST) // полосы 2-3, 4-7, 8-15, 16-31
+#define OCT_STEP (((uint32_t)(OCT_NUM - 1) << 16) / (HALF_LEN - 1))   // шаг по октавам на светодиод, 16.16
+byte oct_f[OCT_NUM];                // октавы с порогом шумов и плавным спадом
+#endif
 int this_color;
 boolean running_flag[3], eeprom_flag;
 
+#if (LED_INDEXED == 0)
+// история 7 режима: кольцо точек по половине ленты, run_head - самая свежая.
+// Цвет хранится как тон + яркость (насыщенность всегда 255), 2 байта на точку
+#define RUN_LEN HALF_LEN
+struct RunDot {
+  byte hue, bright;
+};
+RunDot run_hist[RUN_LEN];
+int run_head;
+#endif
+
+// детектор долей: спектральный поток - сумма прироста бинов FHT с прошлого кадра (спад не считается).
+// Порог адаптивный: бегущее среднее потока + MAX_COEF_FREQ бегущих средних отклонений, всё в целых.
+// Полосы 0-2 - низкие, средние, высокие (вспышки), 3 - весь спектр (темп)
+#define ONSET_BANDS 4
+#define ONSET_AVER 6              // постоянная бегущих средних, 2^6 кадров. Средние хранятся с тем же множителем
+#define BEAT_MIN 300              // допустимый период доли, мс (200 - 60 уд/мин)
+#define BEAT_MAX 1000
+struct Onset {
+  uint32_t mean, dev;             // среднее потока и среднее отклонение, x 2^ONSET_AVER
+  uint16_t flux;                  // сглаженный поток прошлого кадра
+  unsigned long last;             // время последнего срабатывания
+};
+Onset onset[ONSET_BANDS];
+boolean onset_flag[ONSET_BANDS];
+uint16_t beat_period;             // период доли, мс. Темп = 60000 / beat_period уд/мин
+byte beat_conf;                   // уверенность в темпе: подтверждённые подряд доли
+unsigned long beat_last;
+
+#include "bands_iir.h"          // низкие/средние/высокие фильтрами при захвате (BANDS_IIR)
+
+// огибающая громкости для режимов шкалы: АЦП работает по прерыванию (делитель 128, 104 мкс на выборку),
+// поочерёдно с правого и левого канала. В прерывании копится бегущее среднее квадратов (постоянная 2^VU_RMS_SHIFT выборок)
+// и максимум за окно VU_PEAK_WINDOW, основной цикл только читает готовые значения.
+// При ADC_STREAM огибающая копится тем же кодом из общего потока
+#if (ADC_STREAM == 1)
+// поток АЦП: преобразования идут непрерывно (автозапуск, делитель 64, 52 мкс), входы по кругу: R, L (если не MONO), вход частот.
+// Выборки L и входа частот копятся в кольцах по FHT_N с общим указателем, adc_clock - номер круга (метка времени).
+// Для FHT кольца замораживаются (ring_hold), поэтому окна L и R взяты на одних и тех же кругах
+// и сдвинуты друг от друга только на одно преобразование
+#define ADC_SLOTS (MONO ? 2 : 3)
+#define SLOT_FREQ (ADC_SLOTS - 1)
+#define VU_FS (19231 / ADC_SLOTS)       // выборок в секунду на канал
+#define STEREO_SPECTRUM (MONO == 0)
+int16_t ring_freq[FHT_N];
+#if (STEREO_SPECTRUM == 1)
+int16_t ring_l[FHT_N];
+fht_log_t fht_log_l[FHT_N / 2];      // спектр L, fht_spektr - спектр входа частот
+fht_log_t freq_f_l[FHT_N / 2];
+fht_log_t freq_max_l;
+#if (SPEKTR_OCTAVE == 1)
+byte oct_f_l[OCT_NUM];
+#endif
+#endif
+volatile byte ring_head;
+volatile boolean ring_hold;
+volatile uint16_t adc_clock;
+byte adc_mux[ADC_SLOTS];
+byte adc_slot;
+#else
+#define VU_FS (9615 / (MONO ? 1 : 2))   // выборок в секунду на канал
+#define STEREO_SPECTRUM 0
+#endif
+constexpr byte log2floor(long n) { return (n > 1) ? 1 + log2floor(n / 2) : 0; }
+#define VU_RMS_SHIFT log2floor((long)VU_RMS_WINDOW * VU_FS / 1000)
+#define VU_PEAK_SAMPLES ((long)VU_PEAK_WINDOW * VU_FS / 1000 + 1)
+static_assert(VU_RMS_SHIFT <= 12, "VU_RMS_WINDOW too long for 32-bit accumulator");
+#if defined(analogPinToChannel)
+#define ADC_CHANNEL(pin) analogPinToChannel((pin) - A0)
+#else
+#define ADC_CHANNEL(pin) ((pin) - A0)
+#endif
+struct VuEnvelope {
+  uint32_t square;                // сумма квадратов x 2^VU_RMS_SHIFT
+  uint16_t peak_now, peak_last;   // максимум текущего и прошлого окна
+  uint16_t count;
+};
+volatile VuEnvelope vu_env[2];
+volatile byte vu_ch;
+boolean vu_running;
+
+// передискретизация: АЦП в непрерывном режиме (~38 кГц), фильтр CIC 2 порядка с прореживанием в ADC_OVERSAMPLE раз.
+// Коэффициент усиления CIC ADC_OVERSAMPLE^2, выход приводится к 12 битам (0..4092).
+// Регистры CIC 16-битные с переполнением - для CIC это корректно, пока рост разрядности 10 + 2 * log2(R) <= 16
+#define CIC_SHIFT (2 * log2floor(ADC_OVERSAMPLE) - 2)
+static_assert((ADC_OVERSAMPLE & (ADC_OVERSAMPLE - 1)) == 0 && ADC_OVERSAMPLE <= 8, "ADC_OVERSAMPLE must be 1, 2, 4 or 8");
+static_assert(ADC_OVERSAMPLE == 1 || BANDS_IIR == 0 || ADC_STREAM == 1, "ADC_OVERSAMPLE > 1 needs BANDS_IIR 0: the band filters would not match the FHT scale and bins");
+
+#if (LED_INDEXED == 0)
+#include "noise_mode.h"             // шум 9 режима, кэш крупной октавы
+unsigned long noise_timer;
+#if (STRIP_ZIGZAG > 0)
+uint16_t noise_y;             // координата ряда поля шума 12 режима
+#endif
+#endif
+
+// ----- таблица настраиваемых параметров -----
+// тип, шаг и пределы (у float - в сотых долях), ячейка EEPROM (0 - не хранится)
+#define P_BYTE  0
+#define P_INT   1
+#define P_FLOAT 2
+struct Param {
+  void *ptr;
+  byte type;
+  int16_t step, minimum, maximum;
+  byte eeprom;
+  const char *name;
+};
+#define PARAM(var, type, step, minimum, maximum, eeprom) { &var, type, step, minimum, maximum, eeprom, param_##var }
+#define PARAM_NAME(var) const char param_##var[] PROGMEM = #var
+PARAM_NAME(EMPTY_BRIGHT); PARAM_NAME(BRIGHTNESS); PARAM_NAME(RAINBOW_STEP); PARAM_NAME(MAX_COEF_FREQ);
+PARAM_NAME(STROBE_PERIOD); PARAM_NAME(LIGHT_SAT); PARAM_NAME(RAINBOW_STEP_2); PARAM_NAME(HUE_START);
+PARAM_NAME(SMOOTH); PARAM_NAME(SMOOTH_FREQ); PARAM_NAME(STROBE_SMOOTH); PARAM_NAME(LIGHT_COLOR);
+PARAM_NAME(COLOR_SPEED); PARAM_NAME(RAINBOW_PERIOD); PARAM_NAME(RUNNING_SPEED); PARAM_NAME(HUE_STEP);
+
+const Param params[] PROGMEM = {
+  PARAM(EMPTY_BRIGHT,   P_BYTE,  5,   0,    255,  60),    // 0
+  PARAM(BRIGHTNESS,     P_BYTE,  20,  0,    255,  0),     // 1
+  PARAM(RAINBOW_STEP,   P_FLOAT, 50,  50,   2000, 4),     // 2
+  PARAM(MAX_COEF_FREQ,  P_FLOAT, 10,  0,    500,  8),     // 3
+  PARAM(STROBE_PERIOD,  P_INT,   20,  1,    1000, 12),    // 4
+  PARAM(LIGHT_SAT,      P_BYTE,  20,  0,    255,  16),    // 5
+  PARAM(RAINBOW_STEP_2, P_FLOAT, 50,  50,   1000, 20),    // 6
+  PARAM(HUE_START,      P_BYTE,  10,  0,    255,  24),    // 7
+  PARAM(SMOOTH,         P_FLOAT, 5,   5,    100,  28),    // 8
+  PARAM(SMOOTH_FREQ,    P_FLOAT, 5,   5,    100,  32),    // 9
+  PARAM(STROBE_SMOOTH,  P_BYTE,  20,  0,    255,  36),    // 10
+  PARAM(LIGHT_COLOR,    P_BYTE,  10,  0,    255,  40),    // 11
+  PARAM(COLOR_SPEED,    P_BYTE,  10,  0,    255,  44),    // 12
+  PARAM(RAINBOW_PERIOD, P_INT,   1,   -20,  20,   48),    // 13
+  PARAM(RUNNING_SPEED,  P_BYTE,  10,  1,    255,  52),    // 14
+  PARAM(HUE_STEP,       P_BYTE,  1,   1,    255,  56),    // 15
+  PARAM(MAX_COEF_FREQ,  P_FLOAT, 10,  0,    1000, 0),     // 16 - в 7 режиме предел выше
+};
+#define PARAM_AMOUNT (sizeof(params) / sizeof(Param))
+#define PARAM_NONE 0xFF
+
+// какой параметр меняют кнопки пульта: {ВВЕРХ/ВНИЗ, ВЛЕВО/ВПРАВО}
+// строки: режимы 0-5, режим 6 по light_mode (0-2), режимы 7-12 и общие настройки
+const byte param_map[16][2] PROGMEM = {
+  {PARAM_NONE, 8},  // 0
+  {2, 8},           // 1
+  {3, 9},           // 2
+  {3, 9},           // 3
+  {3, 9},           // 4
+  {4, 10},          // 5
+  {5, 11},          // 6, подсветка
+  {5, 12},          // 6, смена цвета
+  {6, 13},          // 6, радуга
+  {16, 14},         // 7
+  {7, 15},          // 8
+  {7, 9},           // 9, шум
+  {7, 14},          // 10, водопад
+  {PARAM_NONE, 8},  // 11, круговая шкала
+  {7, 14},          // 12, поле шума
+  {0, 1},           // settings_mode
+};
+
 #define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
 #define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
 // ------------------------------ ДЛЯ РАЗРАБОТЧИКОВ --------------------------------
 
 void setup() {
   Serial.begin(9600);
-  FastLED.addLeds<WS2811, LED_PIN, GRB>(leds, NUM_LEDS).setCorrection( TypicalLEDStrip );
-  if (CURRENT_LIMIT > 0) FastLED.setMaxPowerInVoltsAndMilliamps(5, CURRENT_LIMIT);
-  FastLED.setBrightness(BRIGHTNESS);
+  ledsBegin();
 
 #if defined(__AVR_ATmega32U4__)   //Выключение светодиодов на Pro Micro
   TXLED1;                           //на ProMicro выключим и TXLED
@@ -290,8 +592,17 @@ void setup() {
   sbi(ADCSRA, ADPS2);
   cbi(ADCSRA, ADPS1);
   sbi(ADCSRA, ADPS0);
+#if (ADC_STREAM == 1)
+  adcStreamBegin();       // дальше АЦП работает только в прерывании
+#endif
 
-  if (RESET_SETTINGS) EEPROM.write(100, 0);        // сброс флага настроек
+  if (RESET_SETTINGS) {                            // сброс флагов настроек и кодов пульта
+    EEPROM.write(100, 0);
+    EEPROM.write(101, 0);
+  }
+#if REMOTE_TYPE != 0
+  irInit();                                        // коды пульта из памяти в хэш-таблицу
+#endif
 
   if (AUTO_LOW_PASS && !EEPROM_LOW_PASS) {         // если разрешена автонастройка нижнего порога шумов
     autoLowPass();
@@ -299,13 +610,14 @@ void setup() {
   if (EEPROM_LOW_PASS) {                // восстановить значения шумов из памяти
     LOW_PASS = EEPROM.readInt(70);
     SPEKTR_LOW_PASS = EEPROM.readInt(72);
+    if (EEPROM.readInt(74) != -1) BANDS_LOW_PASS = EEPROM.readInt(74);   // пустая ячейка (не калибровали с этой версии) - порог по умолчанию
   }
 
-  // в 100 ячейке хранится число 100. Если нет - значит это первый запуск системы
+  // в 100 ячейке хранится число 102 (версия раскладки настроек). Если нет - значит это первый запуск системы
   if (KEEP_SETTINGS) {
-    if (EEPROM.read(100) != 100) {
+    if (EEPROM.read(100) != 102) {
       //Serial.println(F("First start"));
-      EEPROM.write(100, 100);
+      EEPROM.write(100, 102);
       updateEEPROM();
     } else {
       readEEPROM();
@@ -316,21 +628,7 @@ void setup() {
   Serial.print(F("this_mode = ")); Serial.println(this_mode);
   Serial.print(F("freq_strobe_mode = ")); Serial.println(freq_strobe_mode);
   Serial.print(F("light_mode = ")); Serial.println(light_mode);
-  Serial.print(F("RAINBOW_STEP = ")); Serial.println(RAINBOW_STEP);
-  Serial.print(F("MAX_COEF_FREQ = ")); Serial.println(MAX_COEF_FREQ);
-  Serial.print(F("STROBE_PERIOD = ")); Serial.println(STROBE_PERIOD);
-  Serial.print(F("LIGHT_SAT = ")); Serial.println(LIGHT_SAT);
-  Serial.print(F("RAINBOW_STEP_2 = ")); Serial.println(RAINBOW_STEP_2);
-  Serial.print(F("HUE_START = ")); Serial.println(HUE_START);
-  Serial.print(F("SMOOTH = ")); Serial.println(SMOOTH);
-  Serial.print(F("SMOOTH_FREQ = ")); Serial.println(SMOOTH_FREQ);
-  Serial.print(F("STROBE_SMOOTH = ")); Serial.println(STROBE_SMOOTH);
-  Serial.print(F("LIGHT_COLOR = ")); Serial.println(LIGHT_COLOR);
-  Serial.print(F("COLOR_SPEED = ")); Serial.println(COLOR_SPEED);
-  Serial.print(F("RAINBOW_PERIOD = ")); Serial.println(RAINBOW_PERIOD);
-  Serial.print(F("RUNNING_SPEED = ")); Serial.println(RUNNING_SPEED);
-  Serial.print(F("HUE_STEP = ")); Serial.println(HUE_STEP);
-  Serial.print(F("EMPTY_BRIGHT = ")); Serial.println(EMPTY_BRIGHT);
+  for (byte i = 0; i < PARAM_AMOUNT; i++) paramPrint(i);
   Serial.print(F("ONstate = ")); Serial.println(ONstate);
 #endif
 }
@@ -346,21 +644,23 @@ void loop() {
 
 void mainLoop() {
   // главный цикл отрисовки
+#if REMOTE_TYPE != 0
+  if (ir_learn >= 0) return;   // лентой занят режим обучения пульта
+#endif
   if (ONstate) {
     if (millis() - main_timer > MAIN_LOOP) {
       // сбрасываем значения
       RsoundLevel = 0;
       LsoundLevel = 0;
+#if (ADC_STREAM == 0)
+      if (this_mode != 0 && this_mode != 1 && this_mode != 11) vuStop();   // остальным режимам АЦП нужен для analogRead
+#endif
 
       // перваые два режима - громкость (VU meter)
-      if (this_mode == 0 || this_mode == 1) {
-        for (byte i = 0; i < 100; i ++) {                                 // делаем 100 измерений
-          RcurrentLevel = analogRead(SOUND_R);                            // с правого
-          if (!MONO) LcurrentLevel = analogRead(SOUND_L);                 // и левого каналов
-
-          if (RsoundLevel < RcurrentLevel) RsoundLevel = RcurrentLevel;   // ищем максимальное
-          if (!MONO) if (LsoundLevel < LcurrentLevel) LsoundLevel = LcurrentLevel;   // ищем максимальное
-        }
+      if (this_mode == 0 || this_mode == 1 || this_mode == 11) {
+        vuStart();                              // громкость копится в прерывании АЦП
+        RsoundLevel = vuLevel(0);
+        if (!MONO) LsoundLevel = vuLevel(1);
 
         // фильтруем по нижнему порогу шумов
         RsoundLevel = map(RsoundLevel, LOW_PASS, 1023, 0, 500);
@@ -382,8 +682,7 @@ void mainLoop() {
 
         // заливаем "подложку", если яркость достаточная
         if (EMPTY_BRIGHT > 5) {
-          for (int i = 0; i < NUM_LEDS; i++)
-            leds[i] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+          fillLeds(0, NUM_LEDS, ledsColor(PAL_EMPTY, CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT)));
         }
 
         // если значение выше порога - начинаем самое интересное
@@ -396,72 +695,69 @@ void mainLoop() {
           // принимаем максимальную громкость шкалы как среднюю, умноженную на некоторый коэффициент MAX_COEF
           maxLevel = (float)averageLevel * MAX_COEF;
 
-          // преобразуем сигнал в длину ленты (где MAX_CH это половина количества светодиодов)
-          Rlenght = map(RsoundLevel_f, 0, maxLevel, 0, MAX_CH);
-          Llenght = map(LsoundLevel_f, 0, maxLevel, 0, MAX_CH);
+          // преобразуем сигнал в длину половины ленты
+          Rlenght = map(RsoundLevel_f, 0, maxLevel, 0, HALF_LEN);
+          Llenght = map(LsoundLevel_f, 0, maxLevel, 0, HALF_LEN);
 
           // ограничиваем до макс. числа светодиодов
-          Rlenght = constrain(Rlenght, 0, MAX_CH);
-          Llenght = constrain(Llenght, 0, MAX_CH);
+          Rlenght = constrain(Rlenght, 0, HALF_LEN);
+          Llenght = constrain(Llenght, 0, HALF_LEN);
 
           animation();       // отрисовать
         }
       }
 
       // 3-5 режим - цветомузыка
-      if (this_mode == 2 || this_mode == 3 || this_mode == 4 || this_mode == 7 || this_mode == 8) {
-        analyzeAudio();
-        colorMusic[0] = 0;
-        colorMusic[1] = 0;
-        colorMusic[2] = 0;
-        for (int i = 0 ; i < 32 ; i++) {
-          if (fht_log_out[i] < SPEKTR_LOW_PASS) fht_log_out[i] = 0;
-        }
-        // низкие частоты, выборка со 2 по 5 тон (0 и 1 зашумленные!)
-        for (byte i = 2; i < 6; i++) {
-          if (fht_log_out[i] > colorMusic[0]) colorMusic[0] = fht_log_out[i];
-        }
-        // средние частоты, выборка с 6 по 10 тон
-        for (byte i = 6; i < 11; i++) {
-          if (fht_log_out[i] > colorMusic[1]) colorMusic[1] = fht_log_out[i];
-        }
-        // высокие частоты, выборка с 11 по 31 тон
-        for (byte i = 11; i < 32; i++) {
-          if (fht_log_out[i] > colorMusic[2]) colorMusic[2] = fht_log_out[i];
-        }
-        freq_max = 0;
-        for (byte i = 0; i < 30; i++) {
-          if (fht_log_out[i + 2] > freq_max) freq_max = fht_log_out[i + 2];
-          if (freq_max < 5) freq_max = 5;
-
-          if (freq_f[i] < fht_log_out[i + 2]) freq_f[i] = fht_log_out[i + 2];
-          if (freq_f[i] > 0) freq_f[i] -= LIGHT_SMOOTH;
-          else freq_f[i] = 0;
+      if (this_mode == 2 || this_mode == 3 || this_mode == 4 || this_mode == 7 || this_mode == 8 ||
+          this_mode == 9 || this_mode == 10 || this_mode == 12) {
+        if (fullSpectrum()) {
+          analyzeAudio();   // порог шумов и спад freq_f уже сделаны
+          freq_max = max(bandsMax(), 5 << LOG_FRAC);
+#if (STEREO_SPECTRUM == 1)
+          if (freq_max_l > freq_max) freq_max = freq_max_l;
+#endif
+          freq_max_f = freq_max * averK + freq_max_f * (1 - averK);
+        } else {
+          analyzeBands();
         }
-        freq_max_f = freq_max * averK + freq_max_f * (1 - averK);
+        onsetTick();      // вспышки полос - по началу звука, а не по громкости
         for (byte i = 0; i < 3; i++) {
-          colorMusic_aver[i] = colorMusic[i] * averK + colorMusic_aver[i] * (1 - averK);  // общая фильтрация
-          colorMusic_f[i] = colorMusic[i] * SMOOTH_FREQ + colorMusic_f[i] * (1 - SMOOTH_FREQ);      // локальная
-          if (colorMusic_f[i] > ((float)colorMusic_aver[i] * MAX_COEF_FREQ)) {
+          if (onset_flag[i]) {
             thisBright[i] = 255;
             colorMusicFlash[i] = true;
             running_flag[i] = true;
-          } else colorMusicFlash[i] = false;
+          }
+          // вспышка горит, пока не угаснет
           if (thisBright[i] >= 0) thisBright[i] -= SMOOTH_STEP;
           if (thisBright[i] < EMPTY_BRIGHT) {
             thisBright[i] = EMPTY_BRIGHT;
+            colorMusicFlash[i] = false;
             running_flag[i] = false;
           }
         }
         animation();
       }
       if (this_mode == 5) {
-        if ((long)millis() - strobe_timer > STROBE_PERIOD) {
+        unsigned int strobe_period = STROBE_PERIOD;
+#if (STROBE_BEAT == 1)
+        if (fullSpectrum()) analyzeAudio();
+        else analyzeBands();
+        onsetTick();
+        if (beatLocked()) {
+          strobe_period = beat_period;
+          // подстройка фазы по доле: поздняя доля сдвигает отсчёт, ранняя вспыхивает сразу
+          if (onset_flag[3]) {
+            if (millis() - strobe_timer > strobe_period / 2) strobe_timer = millis() - strobe_period - 1;
+            else strobe_timer = millis();
+          }
+        }
+#endif
+        if ((long)millis() - strobe_timer > strobe_period) {
           strobe_timer = millis();
           strobeUp_flag = true;
           strobeDwn_flag = false;
         }
-        if ((long)millis() - strobe_timer > light_time) {
+        if ((long)millis() - strobe_timer > (long)strobe_period * STROBE_DUTY / 100) {
           strobeDwn_flag = true;
         }
         if (strobeUp_flag) {                    // если настало время пыхнуть
@@ -486,10 +782,10 @@ void mainLoop() {
       if (this_mode == 6) animation();
 
       if (!IRLremote.receiving())    // если на ИК приёмник не приходит сигнал (без этого НЕ РАБОТАЕТ!)
-        FastLED.show();         // отправить значения на ленту
+        ledsShow();             // отправить значения на ленту
 
-      if (this_mode != 7)       // 7 режиму не нужна очистка!!!
-        FastLED.clear();          // очистить массив пикселей
+      if (this_mode != 7 && this_mode != 10 && this_mode != 12)  // 7 режим перерисовывает ленту из кольца, 10 и 12 сдвигают кадр
+        ledsClear();              // очистить массив пикселей
       main_timer = millis();    // сбросить таймер
     }
   }
@@ -499,62 +795,46 @@ void animation() {
   // согласно режиму
   switch (this_mode) {
     case 0:
-      count = 0;
-      for (int i = (MAX_CH - 1); i > ((MAX_CH - 1) - Rlenght); i--) {
-        leds[i] = ColorFromPalette(myPal, (count * index));   // заливка по палитре " от зелёного к красному"
-        count++;
-      }
-      count = 0;
-      for (int i = (MAX_CH); i < (MAX_CH + Llenght); i++ ) {
-        leds[i] = ColorFromPalette(myPal, (count * index));   // заливка по палитре " от зелёного к красному"
-        count++;
-      }
-      if (EMPTY_BRIGHT > 0) {
-        CHSV this_dark = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
-        for (int i = ((MAX_CH - 1) - Rlenght); i > 0; i--)
-          leds[i] = this_dark;
-        for (int i = MAX_CH + Llenght; i < NUM_LEDS; i++)
-          leds[i] = this_dark;
-      }
+      gradPalette(myPal);
+      for (int k = 0; k < Rlenght; k++)
+        leds[halfLeft(k)] = GRAD_COLOR(myPal, (k * index));    // заливка по палитре " от зелёного к красному"
+      for (int k = 0; k < Llenght; k++)
+        leds[halfRight(k)] = GRAD_COLOR(myPal, (k * index));
+      halfDark();
       break;
     case 1:
       if (millis() - rainbow_timer > 30) {
         rainbow_timer = millis();
         hue = floor((float)hue + RAINBOW_STEP);
       }
-      count = 0;
-      for (int i = (MAX_CH - 1); i > ((MAX_CH - 1) - Rlenght); i--) {
-        leds[i] = ColorFromPalette(RainbowColors_p, (count * index) / 2 - hue);  // заливка по палитре радуга
-        count++;
-      }
-      count = 0;
-      for (int i = (MAX_CH); i < (MAX_CH + Llenght); i++ ) {
-        leds[i] = ColorFromPalette(RainbowColors_p, (count * index) / 2 - hue); // заливка по палитре радуга
-        count++;
-      }
-      if (EMPTY_BRIGHT > 0) {
-        CHSV this_dark = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
-        for (int i = ((MAX_CH - 1) - Rlenght); i > 0; i--)
-          leds[i] = this_dark;
-        for (int i = MAX_CH + Llenght; i < NUM_LEDS; i++)
-          leds[i] = this_dark;
-      }
+      gradPalette(RainbowColors_p);
+      for (int k = 0; k < Rlenght; k++)
+        leds[halfLeft(k)] = GRAD_COLOR(RainbowColors_p, (k * index) / 2 - hue);   // заливка по палитре радуга
+      for (int k = 0; k < Llenght; k++)
+        leds[halfRight(k)] = GRAD_COLOR(RainbowColors_p, (k * index) / 2 - hue);
+      halfDark();
       break;
-    case 2:
-      for (int i = 0; i < NUM_LEDS; i++) {
-        if (i < STRIPE)          leds[i] = CHSV(HIGH_COLOR, 255, thisBright[2]);
-        else if (i < STRIPE * 2) leds[i] = CHSV(MID_COLOR, 255, thisBright[1]);
-        else if (i < STRIPE * 3) leds[i] = CHSV(LOW_COLOR, 255, thisBright[0]);
-        else if (i < STRIPE * 4) leds[i] = CHSV(MID_COLOR, 255, thisBright[1]);
-        else if (i < STRIPE * 5) leds[i] = CHSV(HIGH_COLOR, 255, thisBright[2]);
-      }
+    case 2: {
+      // три цвета на кадр переводим в RGB один раз, а не на каждый светодиод
+      led_t high = ledsColor(PAL_HIGH, CHSV(HIGH_COLOR, 255, thisBright[2]));
+      led_t mid = ledsColor(PAL_MID, CHSV(MID_COLOR, 255, thisBright[1]));
+      led_t low = ledsColor(PAL_LOW, CHSV(LOW_COLOR, 255, thisBright[0]));
+      // 5 полос: высокие, средние, низкие, средние, высокие
+      fillSegment(0, 5, high);
+      fillSegment(1, 5, mid);
+      fillSegment(2, 5, low);
+      fillSegment(3, 5, mid);
+      fillSegment(4, 5, high);
+    }
       break;
-    case 3:
-      for (int i = 0; i < NUM_LEDS; i++) {
-        if (i < NUM_LEDS / 3)          leds[i] = CHSV(HIGH_COLOR, 255, thisBright[2]);
-        else if (i < NUM_LEDS * 2 / 3) leds[i] = CHSV(MID_COLOR, 255, thisBright[1]);
-        else if (i < NUM_LEDS)         leds[i] = CHSV(LOW_COLOR, 255, thisBright[0]);
-      }
+    case 3: {
+      led_t high = ledsColor(PAL_HIGH, CHSV(HIGH_COLOR, 255, thisBright[2]));
+      led_t mid = ledsColor(PAL_MID, CHSV(MID_COLOR, 255, thisBright[1]));
+      led_t low = ledsColor(PAL_LOW, CHSV(LOW_COLOR, 255, thisBright[0]));
+      fillSegment(0, 3, high);
+      fillSegment(1, 3, mid);
+      fillSegment(2, 3, low);
+    }
       break;
     case 4:
       switch (freq_strobe_mode) {
@@ -580,20 +860,20 @@ void animation() {
       break;
     case 5:
       if (strobe_bright > 0)
-        for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(STROBE_COLOR, STROBE_SAT, strobe_bright);
+        fillLeds(0, NUM_LEDS, ledsColor(PAL_FILL, CHSV(STROBE_COLOR, STROBE_SAT, strobe_bright)));
       else
-        for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+        fillLeds(0, NUM_LEDS, ledsColor(PAL_EMPTY, CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT)));
       break;
     case 6:
       switch (light_mode) {
-        case 0: for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(LIGHT_COLOR, LIGHT_SAT, 255);
+        case 0: fillLeds(0, NUM_LEDS, ledsColor(PAL_FILL, CHSV(LIGHT_COLOR, LIGHT_SAT, 255)));
           break;
         case 1:
           if (millis() - color_timer > COLOR_SPEED) {
             color_timer = millis();
             if (++this_color > 255) this_color = 0;
           }
-          for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(this_color, LIGHT_SAT, 255);
+          fillLeds(0, NUM_LEDS, ledsColor(PAL_FILL, CHSV(this_color, LIGHT_SAT, 255)));
           break;
         case 2:
           if (millis() - rainbow_timer > 30) {
@@ -603,70 +883,296 @@ void animation() {
             if (this_color < 0) this_color = 255;
           }
           rainbow_steps = this_color;
+#if (LED_INDEXED == 1)
+          for (byte j = 0; j < PAL_STEPS; j++) ledsPal[PAL_GRAD + j] = CHSV(j * GRAD_STEP + GRAD_STEP / 2, 255, 255);
+#endif
           for (int i = 0; i < NUM_LEDS; i++) {
-            leds[i] = CHSV((int)floor(rainbow_steps), 255, 255);
+#if (LED_INDEXED == 1)
+            leds[i] = GRAD_COLOR(0, floor(rainbow_steps));   // тон ступенями, палитра не нужна
+#else
+            ((CHSV *)leds)[i] = CHSV((int)floor(rainbow_steps), 255, 255);
+#endif
             rainbow_steps += RAINBOW_STEP_2;
             if (rainbow_steps > 255) rainbow_steps = 0;
             if (rainbow_steps < 0) rainbow_steps = 255;
           }
+#if (LED_INDEXED == 0)
+          hsv2rgb_rainbow((CHSV *)leds, leds, NUM_LEDS);    // перевод всей ленты в RGB одним пакетом, на месте
+#endif
           break;
       }
       break;
-    case 7:
+#if (LED_INDEXED == 0)      // режимы 7-12 рисуют каждый светодиод своим цветом, индексному кадру не подходят
+    case 7: {
+      byte run_hue = EMPTY_COLOR, run_bright = EMPTY_BRIGHT;
       switch (freq_strobe_mode) {
         case 0:
-          if (running_flag[2]) leds[NUM_LEDS / 2] = CHSV(HIGH_COLOR, 255, thisBright[2]);
-          else if (running_flag[1]) leds[NUM_LEDS / 2] = CHSV(MID_COLOR, 255, thisBright[1]);
-          else if (running_flag[0]) leds[NUM_LEDS / 2] = CHSV(LOW_COLOR, 255, thisBright[0]);
-          else leds[NUM_LEDS / 2] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+          if (running_flag[2]) { run_hue = HIGH_COLOR; run_bright = thisBright[2]; }
+          else if (running_flag[1]) { run_hue = MID_COLOR; run_bright = thisBright[1]; }
+          else if (running_flag[0]) { run_hue = LOW_COLOR; run_bright = thisBright[0]; }
           break;
         case 1:
-          if (running_flag[2]) leds[NUM_LEDS / 2] = CHSV(HIGH_COLOR, 255, thisBright[2]);
-          else leds[NUM_LEDS / 2] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+          if (running_flag[2]) { run_hue = HIGH_COLOR; run_bright = thisBright[2]; }
           break;
         case 2:
-          if (running_flag[1]) leds[NUM_LEDS / 2] = CHSV(MID_COLOR, 255, thisBright[1]);
-          else leds[NUM_LEDS / 2] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+          if (running_flag[1]) { run_hue = MID_COLOR; run_bright = thisBright[1]; }
           break;
         case 3:
-          if (running_flag[0]) leds[NUM_LEDS / 2] = CHSV(LOW_COLOR, 255, thisBright[0]);
-          else leds[NUM_LEDS / 2] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+          if (running_flag[0]) { run_hue = LOW_COLOR; run_bright = thisBright[0]; }
           break;
       }
-      leds[(NUM_LEDS / 2) - 1] = leds[NUM_LEDS / 2];
-      if (millis() - running_timer > RUNNING_SPEED) {
+      run_hist[run_head].hue = run_hue;         // свежая точка горит "вживую" до следующего шага
+      run_hist[run_head].bright = run_bright;
+
+      // за каждые прошедшие RUNNING_SPEED мс голова кольца сдвигается на точку,
+      // лента при этом не двигается - сдвиг стоит одинаково при любой длине
+      unsigned int run_steps = (millis() - running_timer) / RUNNING_SPEED;
+      if (run_steps > RUN_LEN) {
+        run_steps = RUN_LEN;
         running_timer = millis();
-        for (int i = 0; i < NUM_LEDS / 2 - 1; i++) {
-          leds[i] = leds[i + 1];
-          leds[NUM_LEDS - i - 1] = leds[i];
-        }
+      } else {
+        running_timer += run_steps * RUNNING_SPEED;
+      }
+      while (run_steps--) {
+        if (++run_head >= RUN_LEN) run_head = 0;
+        run_hist[run_head].hue = run_hue;
+        run_hist[run_head].bright = run_bright;
       }
+
+      // разворачиваем кольцо на половину ленты: свежая точка в центре, старые уходят к краю
+      int j = run_head;
+      for (int k = 0; k < RUN_LEN; k++) {
+        leds[halfRight(k)] = CHSV(run_hist[j].hue, 255, run_hist[j].bright);
+        if (--j < 0) j = RUN_LEN - 1;
+      }
+      mirrorHalf();
+    }
       break;
-    case 8:
+    case 8: {
       byte HUEindex = HUE_START;
-      for (int i = 0; i < NUM_LEDS / 2; i++) {
-        byte this_bright = map(freq_f[(int)floor((NUM_LEDS / 2 - i) / freq_to_stripe)], 0, freq_max_f, 0, 255);
+#if (SPEKTR_OCTAVE == 1)
+      // яркость считается на 4 октавы, светодиоды - интерполяция между соседними
+      byte oct_bright[OCT_NUM];
+      octaveBright(oct_f, oct_bright);
+#if (STEREO_SPECTRUM == 1)
+      byte oct_bright_l[OCT_NUM];
+      octaveBright(oct_f_l, oct_bright_l);
+#endif
+      uint32_t oct_pos = (uint32_t)(OCT_NUM - 1) << 16;   // край ленты - верхняя октава, центр - нижняя
+#endif
+      // i - от края ленты к центру, рисуем правую половину
+      for (int i = 0; i < HALF_LEN; i++) {
+#if (SPEKTR_OCTAVE == 1)
+        byte this_bright = octaveLerp(oct_bright, oct_pos);
+#else
+        int this_freq = (int)floor((HALF_LEN - i) / freq_to_stripe) + 2;   // бины 0 и 1 зашумлены
+        if (this_freq > FHT_N / 2 - 1) this_freq = FHT_N / 2 - 1;           // край ленты - последний бин
+        byte this_bright = map(freq_f[this_freq], 0, freq_max_f, 0, 255);
         this_bright = constrain(this_bright, 0, 255);
-        leds[i] = CHSV(HUEindex, 255, this_bright);
-        leds[NUM_LEDS - i - 1] = leds[i];
+#endif
+        ((CHSV *)leds)[NUM_LEDS - 1 - i] = CHSV(HUEindex, 255, this_bright);   // пока храним HSV прямо в leds
+#if (STEREO_SPECTRUM == 1)
+#if (SPEKTR_OCTAVE == 1)
+        this_bright = octaveLerp(oct_bright_l, oct_pos);
+#else
+        this_bright = constrain(map(freq_f_l[this_freq], 0, freq_max_f, 0, 255), 0, 255);
+#endif
+        ((CHSV *)leds)[i] = CHSV(HUEindex, 255, this_bright);                  // левая половина - спектр L
+#endif
+#if (SPEKTR_OCTAVE == 1)
+        oct_pos -= OCT_STEP;
+#endif
         HUEindex += HUE_STEP;
         if (HUEindex > 255) HUEindex = 0;
       }
+#if (STEREO_SPECTRUM == 1)
+      hsv2rgb_rainbow((CHSV *)leds, leds, NUM_LEDS);
+#else
+      hsv2rgb_rainbow((CHSV *)leds + halfRight(0), leds + halfRight(0), HALF_LEN);
+      mirrorHalf();
+#endif
+    }
+      break;
+    case 9:
+      // крупная октава по таймеру, мелкая - каждый кадр
+      if (millis() - noise_timer > NOISE_BASE_PERIOD) {
+        noise_timer = millis();
+        noiseBase(NUM_LEDS, thisBright[1]);
+      }
+      noiseFrame(NUM_LEDS, thisBright[0], thisBright[1], thisBright[2]);
       break;
+#if (STRIP_ZIGZAG > 0)
+    case 10:
+      // водопад спектра: за кадр считается только верхний ряд, остальные сдвигаются
+      matrixScroll();
+      for (byte x = 0; x < MATRIX_W; x++) {
+        byte this_bright = constrain(map(freq_f[x * 30 / MATRIX_W + 2], 0, freq_max_f, 0, 255), 0, 255);
+        ((CHSV *)leds)[x] = CHSV(HUE_START + x * HUE_STEP, 255, this_bright);
+      }
+      hsv2rgb_rainbow((CHSV *)leds, leds, MATRIX_W);
+      break;
+    case 11: {
+#if (PALETTE_CACHE == 1)
+      palCache.update(myPal);
+#endif
+      // круг из центра матрицы, радиус - средняя громкость каналов.
+      // Координаты удвоены, чтобы центр чётной матрицы попадал между светодиодами
+      byte r_max = sqrt16((MATRIX_W - 1) * (MATRIX_W - 1) + (MATRIX_H - 1) * (MATRIX_H - 1));
+      uint16_t r = (long)r_max * (Rlenght + Llenght) / (2 * HALF_LEN);
+      uint16_t r2 = r * r;
+      for (byte y = 0; y < MATRIX_H; y++) {
+        int dy = 2 * y - (MATRIX_H - 1);
+        for (byte x = 0; x < MATRIX_W; x++) {
+          int dx = 2 * x - (MATRIX_W - 1);
+          uint16_t d2 = dx * dx + dy * dy;
+          if (d2 <= r2) leds[XY(x, y)] = PALETTE_COLOR(myPal, sqrt16(d2) * 255 / r_max);
+        }
+      }
+      blur2d(leds, MATRIX_W, MATRIX_H, 64);
+    }
+      break;
+    case 12:
+      // поле шума: бас ускоряет течение, середина мельчит узор, верх сдвигает цвет.
+      // Шум считается только для верхнего ряда, остальные сдвигаются как в водопаде
+      noise_t += 4 + (thisBright[0] >> 4);
+      if (matrixScroll()) noise_y += 30;
+      fill_2dnoise8(leds, MATRIX_W, 1, false,
+                    1, 0, 30 + (thisBright[1] >> 2), noise_y, 0, noise_t,
+                    1, HUE_START << 8, 20, noise_y + (thisBright[2] << 2), 0, noise_t, false);
+      nscale8_video(leds, MATRIX_W, max(max(thisBright[0], thisBright[1]), thisBright[2]));
+      break;
+#endif
+#endif
   }
 }
 
 void HIGHS() {
-  for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(HIGH_COLOR, 255, thisBright[2]);
+  fillLeds(0, NUM_LEDS, ledsColor(PAL_HIGH, CHSV(HIGH_COLOR, 255, thisBright[2])));
 }
 void MIDS() {
-  for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(MID_COLOR, 255, thisBright[1]);
+  fillLeds(0, NUM_LEDS, ledsColor(PAL_MID, CHSV(MID_COLOR, 255, thisBright[1])));
 }
 void LOWS() {
-  for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(LOW_COLOR, 255, thisBright[0]);
+  fillLeds(0, NUM_LEDS, ledsColor(PAL_LOW, CHSV(LOW_COLOR, 255, thisBright[0])));
 }
 void SILENCE() {
-  for (int i = 0; i < NUM_LEDS; i++) leds[i] = CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT);
+  fillLeds(0, NUM_LEDS, ledsColor(PAL_EMPTY, CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT)));
+}
+
+// ----- детектор долей
+void onsetTick() {
+  uint16_t flux[ONSET_BANDS] = {0, 0, 0, 0};
+  if (fullSpectrum()) {
+    for (byte b = 0; b < 3; b++) {        // прирост по полосам fht_bands посчитан в fht_mag_log_bands
+      flux[b] = fht_band_flux[b] >> LOG_FRAC;
+      flux[3] += flux[b];
+    }
+  } else {
+    for (byte b = 0; b < 3; b++) {
+      byte this_val = (band_level[b] < BANDS_LOW_PASS) ? 0 : band_level[b];
+      if (this_val > band_prev[b]) {
+        flux[b] = this_val - band_prev[b];
+        flux[3] += flux[b];
+      }
+      band_prev[b] = this_val;
+    }
+  }
+
+  byte smooth = SMOOTH_FREQ * 255;
+  uint16_t coef = MAX_COEF_FREQ * 16;
+  for (byte b = 0; b < ONSET_BANDS; b++) {
+    Onset &o = onset[b];
+    uint16_t this_flux = ((uint32_t)flux[b] * smooth + (uint32_t)o.flux * (255 - smooth)) / 255;
+    uint32_t x = (uint32_t)this_flux << ONSET_AVER;
+    uint32_t threshold = o.mean + ((o.dev * coef) >> 4) + ((uint32_t)ONSET_MIN << ONSET_AVER);
+    // срабатываем на фронте, не чаще ONSET_HOLD
+    onset_flag[b] = (x > threshold && this_flux > o.flux && millis() - o.last > ONSET_HOLD);
+    if (onset_flag[b]) o.last = millis();
+    o.flux = this_flux;
+
+    uint32_t deviation = (x > o.mean) ? x - o.mean : o.mean - x;
+    o.dev += (deviation >> ONSET_AVER) - (o.dev >> ONSET_AVER);
+    o.mean += (x >> ONSET_AVER) - (o.mean >> ONSET_AVER);
+  }
+
+  // темп: интервал между долями всего спектра. Частые доли (восьмые) пропускаем,
+  // длинный интервал делим пополам - пропущенные доли
+  if (onset_flag[3]) {
+    unsigned long interval = millis() - beat_last;
+    if (interval >= BEAT_MIN) {
+      beat_last = millis();
+      while (interval > BEAT_MAX) interval >>= 1;
+      if (interval >= BEAT_MIN && beat_period && abs((int)interval - (int)beat_period) < beat_period / 8) {
+        beat_period += ((int)interval - (int)beat_period) / 4;
+        if (beat_conf < 8) beat_conf++;
+      } else if (beat_conf > 0) {
+        beat_conf--;
+      } else if (interval >= BEAT_MIN) {
+        beat_period = interval;
+      }
+    }
+  }
+}
+// темп найден: несколько долей подряд совпали и музыка не остановилась
+boolean beatLocked() {
+  return beat_conf >= 3 && millis() - beat_last < 3 * beat_period;
+}
+
+// ----- отрисовка по геометрии ленты
+// цвет для кадра: в индексном кадре кладётся в ячейку палитры slot и возвращается номер ячейки
+led_t ledsColor(byte slot, const CRGB &color) {
+#if (LED_INDEXED == 1)
+  ledsPal[slot] = color;
+  return slot;
+#else
+  return color;
+#endif
+}
+// заливка count светодиодов одним цветом, начиная с from
+void fillLeds(int from, int count, led_t color) {
+#if (LED_INDEXED == 1)
+  memset(leds + from, color, count);
+#else
+  fill_solid(leds + from, count, color);
+#endif
+}
+// левая половина = зеркало правой
+void mirrorHalf() {
+  for (int k = 0; k < HALF_LEN; k++) leds[halfLeft(k)] = leds[halfRight(k)];
+}
+// "не горящие" светодиоды половин после столбиков Rlenght / Llenght
+void halfDark() {
+  if (EMPTY_BRIGHT == 0) return;
+  led_t this_dark = ledsColor(PAL_EMPTY, CHSV(EMPTY_COLOR, 255, EMPTY_BRIGHT));
+  for (int k = Rlenght; k < HALF_LEN; k++) leds[halfLeft(k)] = this_dark;
+  for (int k = Llenght; k < HALF_LEN; k++) leds[halfRight(k)] = this_dark;
+}
+void fillSegment(byte seg, byte segments, led_t color) {
+  fillLeds(segStart(seg, segments), segStart(seg + 1, segments) - segStart(seg, segments), color);
+}
+#if (STRIP_ZIGZAG > 0)
+// логические координаты матрицы для blur2d и матричных режимов, змейка применяется при выводе
+uint16_t XY(uint8_t x, uint8_t y) {
+  return y * MATRIX_W + x;
+}
+// сдвиг матрицы на ряд раз в RUNNING_SPEED мс, верхний ряд рисуется заново каждый кадр
+boolean matrixScroll() {
+  if (millis() - running_timer < RUNNING_SPEED) return false;
+  running_timer = millis();
+  memmove(leds + MATRIX_W, leds, (NUM_LEDS - MATRIX_W) * sizeof(CRGB));
+  return true;
+}
+#endif
+// змейка: разворот нечётных рядов. Повторный вызов возвращает логический порядок
+void zigzagPass() {
+#if (STRIP_ZIGZAG > 0)
+  for (int row = STRIP_ZIGZAG; row + STRIP_ZIGZAG <= NUM_LEDS; row += 2 * STRIP_ZIGZAG)
+    for (int i = 0; i < STRIP_ZIGZAG / 2; i++) {
+      led_t c = leds[row + i];
+      leds[row + i] = leds[zigzag(row + i)];
+      leds[zigzag(row + i)] = c;
+    }
+#endif
 }
 
 // вспомогательная функция, изменяет величину value на шаг incr в пределах minimum.. maximum
@@ -682,41 +1188,104 @@ float smartIncrFloat(float value, float incr_step, float mininmum, float maximum
   return val_buf;
 }
 
+// параметр, который сейчас меняют кнопки пульта по оси axis (0 - вверх/вниз, 1 - влево/вправо)
+byte paramFor(byte axis) {
+  byte row;
+  if (settings_mode) row = 15;
+  else if (this_mode < 6) row = this_mode;
+  else if (this_mode == 6) row = 6 + light_mode;
+  else row = this_mode + 2;
+  return pgm_read_byte(&param_map[row][axis]);
+}
+
+// изменить параметр на шаг из таблицы в направлении dir (1 / -1)
+void paramIncr(byte axis, int8_t dir) {
+  byte num = paramFor(axis);
+  if (num == PARAM_NONE) return;
+  Param p;
+  memcpy_P(&p, &params[num], sizeof(Param));
+  switch (p.type) {
+    case P_BYTE: *(byte*)p.ptr = smartIncr(*(byte*)p.ptr, p.step * dir, p.minimum, p.maximum);
+      break;
+    case P_INT: *(int*)p.ptr = smartIncr(*(int*)p.ptr, p.step * dir, p.minimum, p.maximum);
+      break;
+    case P_FLOAT: *(float*)p.ptr = smartIncrFloat(*(float*)p.ptr, p.step * dir / 100.0, p.minimum / 100.0, p.maximum / 100.0);
+      break;
+  }
+  if (p.ptr == &BRIGHTNESS) ledsBrightness(BRIGHTNESS);
+}
+
+// сохранить (save = true) или прочитать параметр из EEPROM
+void paramEEPROM(byte num, boolean save) {
+  Param p;
+  memcpy_P(&p, &params[num], sizeof(Param));
+  if (p.eeprom == 0) return;
+  switch (p.type) {
+    case P_BYTE: if (save) EEPROM.updateByte(p.eeprom, *(byte*)p.ptr); else *(byte*)p.ptr = EEPROM.readByte(p.eeprom);
+      break;
+    case P_INT: if (save) EEPROM.updateInt(p.eeprom, *(int*)p.ptr); else *(int*)p.ptr = EEPROM.readInt(p.eeprom);
+      break;
+    case P_FLOAT: if (save) EEPROM.updateFloat(p.eeprom, *(float*)p.ptr); else *(float*)p.ptr = EEPROM.readFloat(p.eeprom);
+      break;
+  }
+}
+
+void paramPrint(byte num) {
+  Param p;
+  memcpy_P(&p, &params[num], sizeof(Param));
+  Serial.print((__FlashStringHelper*)p.name); Serial.print(F(" = "));
+  switch (p.type) {
+    case P_BYTE: Serial.println(*(byte*)p.ptr);
+      break;
+    case P_INT: Serial.println(*(int*)p.ptr);
+      break;
+    case P_FLOAT: Serial.println(*(float*)p.ptr);
+      break;
+  }
+}
+
 #if REMOTE_TYPE != 0
 void remoteTick() {
+  if (ir_learn >= 0 && millis() - ir_learn_timer > IR_LEARN_TIMEOUT) irLearnStop();   // пульт молчит - выходим
   if (IRLremote.available())  {
     auto data = IRLremote.read();
     IRdata = data.command;
+    if (ir_learn >= 0) {                  // режим обучения, код не исполняем
+      if (data.address >= IR_MIN_LENGTH) irLearn(IRdata);
+      return;
+    }
     ir_flag = true;
   }
   if (ir_flag) { // если данные пришли
     eeprom_timer = millis();
     eeprom_flag = true;
-    switch (IRdata) {
+    switch (irAction(IRdata)) {
       // режимы
-      case BUTT_1: this_mode = 0;
+      case IR_1: this_mode = 0;
         break;
-      case BUTT_2: this_mode = 1;
+      case IR_2: this_mode = 1;
         break;
-      case BUTT_3: this_mode = 2;
+      case IR_3: this_mode = 2;
         break;
-      case BUTT_4: this_mode = 3;
+      case IR_4: this_mode = 3;
         break;
-      case BUTT_5: this_mode = 4;
+      case IR_5: this_mode = 4;
         break;
-      case BUTT_6: this_mode = 5;
+      case IR_6: this_mode = 5;
         break;
-      case BUTT_7: this_mode = 6;
+      case IR_7: this_mode = 6;
         break;
-      case BUTT_8: this_mode = 7;
+#if (MODE_AMOUNT > 7)
+      case IR_8: this_mode = 7;
         break;
-      case BUTT_9: this_mode = 8;
+      case IR_9: this_mode = 8;
         break;
-      case BUTT_0: fullLowPass();
+#endif
+      case IR_0: fullLowPass();
         break;
-      case BUTT_STAR: ONstate = !ONstate; FastLED.clear(); FastLED.show(); updateEEPROM();
+      case IR_STAR: ONstate = !ONstate; ledsClear(); ledsShow(); updateEEPROM();
         break;
-      case BUTT_HASH:
+      case IR_HASH:
         switch (this_mode) {
           case 4:
           case 7: if (++freq_strobe_mode > 3) freq_strobe_mode = 0;
@@ -725,139 +1294,15 @@ void remoteTick() {
             break;
         }
         break;
-      case BUTT_OK: digitalWrite(MLED_PIN, settings_mode ^ MLED_ON); settings_mode = !settings_mode;
+      case IR_OK: digitalWrite(MLED_PIN, settings_mode ^ MLED_ON); settings_mode = !settings_mode;
         break;
-      case BUTT_UP:
-        if (settings_mode) {
-          // ВВЕРХ общие настройки
-          EMPTY_BRIGHT = smartIncr(EMPTY_BRIGHT, 5, 0, 255);
-        } else {
-          switch (this_mode) {
-            case 0:
-              break;
-            case 1: RAINBOW_STEP = smartIncrFloat(RAINBOW_STEP, 0.5, 0.5, 20);
-              break;
-            case 2:
-            case 3:
-            case 4: MAX_COEF_FREQ = smartIncrFloat(MAX_COEF_FREQ, 0.1, 0, 5);
-              break;
-            case 5: STROBE_PERIOD = smartIncr(STROBE_PERIOD, 20, 1, 1000);
-              break;
-            case 6:
-              switch (light_mode) {
-                case 0: LIGHT_SAT = smartIncr(LIGHT_SAT, 20, 0, 255);
-                  break;
-                case 1: LIGHT_SAT = smartIncr(LIGHT_SAT, 20, 0, 255);
-                  break;
-                case 2: RAINBOW_STEP_2 = smartIncrFloat(RAINBOW_STEP_2, 0.5, 0.5, 10);
-                  break;
-              }
-              break;
-            case 7: MAX_COEF_FREQ = smartIncrFloat(MAX_COEF_FREQ, 0.1, 0.0, 10);
-              break;
-            case 8: HUE_START = smartIncr(HUE_START, 10, 0, 255);
-              break;
-          }
-        }
+      case IR_UP: paramIncr(0, 1);
         break;
-      case BUTT_DOWN:
-        if (settings_mode) {
-          // ВНИЗ общие настройки
-          EMPTY_BRIGHT = smartIncr(EMPTY_BRIGHT, -5, 0, 255);
-        } else {
-          switch (this_mode) {
-            case 0:
-              break;
-            case 1: RAINBOW_STEP = smartIncrFloat(RAINBOW_STEP, -0.5, 0.5, 20);
-              break;
-            case 2:
-            case 3:
-            case 4: MAX_COEF_FREQ = smartIncrFloat(MAX_COEF_FREQ, -0.1, 0, 5);
-              break;
-            case 5: STROBE_PERIOD = smartIncr(STROBE_PERIOD, -20, 1, 1000);
-              break;
-            case 6:
-              switch (light_mode) {
-                case 0: LIGHT_SAT = smartIncr(LIGHT_SAT, -20, 0, 255);
-                  break;
-                case 1: LIGHT_SAT = smartIncr(LIGHT_SAT, -20, 0, 255);
-                  break;
-                case 2: RAINBOW_STEP_2 = smartIncrFloat(RAINBOW_STEP_2, -0.5, 0.5, 10);
-                  break;
-              }
-              break;
-            case 7: MAX_COEF_FREQ = smartIncrFloat(MAX_COEF_FREQ, -0.1, 0.0, 10);
-              break;
-            case 8: HUE_START = smartIncr(HUE_START, -10, 0, 255);
-              break;
-          }
-        }
+      case IR_DOWN: paramIncr(0, -1);
         break;
-      case BUTT_LEFT:
-        if (settings_mode) {
-          // ВЛЕВО общие настройки
-          BRIGHTNESS = smartIncr(BRIGHTNESS, -20, 0, 255);
-          FastLED.setBrightness(BRIGHTNESS);
-        } else {
-          switch (this_mode) {
-            case 0:
-            case 1: SMOOTH = smartIncrFloat(SMOOTH, -0.05, 0.05, 1);
-              break;
-            case 2:
-            case 3:
-            case 4: SMOOTH_FREQ = smartIncrFloat(SMOOTH_FREQ, -0.05, 0.05, 1);
-              break;
-            case 5: STROBE_SMOOTH = smartIncr(STROBE_SMOOTH, -20, 0, 255);
-              break;
-            case 6:
-              switch (light_mode) {
-                case 0: LIGHT_COLOR = smartIncr(LIGHT_COLOR, -10, 0, 255);
-                  break;
-                case 1: COLOR_SPEED = smartIncr(COLOR_SPEED, -10, 0, 255);
-                  break;
-                case 2: RAINBOW_PERIOD = smartIncr(RAINBOW_PERIOD, -1, -20, 20);
-                  break;
-              }
-              break;
-            case 7: RUNNING_SPEED = smartIncr(RUNNING_SPEED, -10, 1, 255);
-              break;
-            case 8: HUE_STEP = smartIncr(HUE_STEP, -1, 1, 255);
-              break;
-          }
-        }
+      case IR_LEFT: paramIncr(1, -1);
         break;
-      case BUTT_RIGHT:
-        if (settings_mode) {
-          // ВПРАВО общие настройки
-          BRIGHTNESS = smartIncr(BRIGHTNESS, 20, 0, 255);
-          FastLED.setBrightness(BRIGHTNESS);
-        } else {
-          switch (this_mode) {
-            case 0:
-            case 1: SMOOTH = smartIncrFloat(SMOOTH, 0.05, 0.05, 1);
-              break;
-            case 2:
-            case 3:
-            case 4: SMOOTH_FREQ = smartIncrFloat(SMOOTH_FREQ, 0.05, 0.05, 1);
-              break;
-            case 5: STROBE_SMOOTH = smartIncr(STROBE_SMOOTH, 20, 0, 255);
-              break;
-            case 6:
-              switch (light_mode) {
-                case 0: LIGHT_COLOR = smartIncr(LIGHT_COLOR, 10, 0, 255);
-                  break;
-                case 1: COLOR_SPEED = smartIncr(COLOR_SPEED, 10, 0, 255);
-                  break;
-                case 2: RAINBOW_PERIOD = smartIncr(RAINBOW_PERIOD, 1, -20, 20);
-                  break;
-              }
-              break;
-            case 7: RUNNING_SPEED = smartIncr(RUNNING_SPEED, 10, 1, 255);
-              break;
-            case 8: HUE_STEP = smartIncr(HUE_STEP, 1, 1, 255);
-              break;
-          }
-        }
+      case IR_RIGHT: paramIncr(1, 1);
         break;
       default: eeprom_flag = false;   // если не распознали кнопку, не обновляем настройки!
         break;
@@ -865,15 +1310,95 @@ void remoteTick() {
     ir_flag = false;
   }
 }
+
+byte irHash(uint32_t code) {
+  // младший байт у хэшей CHashIR почти всегда одинаковый, мешаем старшие
+  return ((byte)(code >> 8) ^ (byte)(code >> 16) ^ (byte)(code >> 24)) & (IR_SLOTS - 1);
+}
+
+uint32_t irCode(byte action) {
+  return ir_codes[action];
+}
+
+// логическая кнопка по коду пульта, одинаковая цена для любого пульта
+byte irAction(uint32_t code) {
+  byte slot = irHash(code);
+  for (byte i = 0; i < IR_SLOTS; i++) {
+    byte action = ir_slots[slot];
+    if (action == IR_NONE) break;
+    if (irCode(action) == code) return action;
+    slot = (slot + 1) & (IR_SLOTS - 1);
+  }
+  return IR_NONE;
+}
+
+void irBuildTable() {
+  memset(ir_slots, IR_NONE, IR_SLOTS);
+  for (byte action = 0; action < IR_KEYS; action++) {
+    uint32_t code = irCode(action);
+    if (code == 0 || irAction(code) != IR_NONE) continue;   // пустой или повторяющийся код
+    byte slot = irHash(code);
+    while (ir_slots[slot] != IR_NONE) slot = (slot + 1) & (IR_SLOTS - 1);
+    ir_slots[slot] = action;
+  }
+}
+
+void irInit() {
+  // в 101 ячейке хранится число 101, если коды пульта уже записаны
+  if (EEPROM.read(101) != 101) {
+    EEPROM.write(101, 101);
+    for (byte action = 0; action < IR_KEYS; action++)
+      EEPROM.updateLong(IR_EEPROM + action * 4, pgm_read_dword(&ir_default[action]));
+  }
+  for (byte action = 0; action < IR_KEYS; action++)
+    ir_codes[action] = EEPROM.readLong(IR_EEPROM + action * 4);
+  irBuildTable();
+}
+
+void irLearnStart() {
+  ir_learn = 0;
+  ir_learn_timer = millis();
+  irLearnShow();
+}
+
+void irLearnStop() {
+  ir_learn = -1;
+  irBuildTable();
+  ledsClear();
+  ledsShow();
+}
+
+// кнопка пульта для ir_learn получила код (или пропущена, если code = 0)
+void irLearn(uint32_t code) {
+  if (code != 0) {
+    if (millis() - ir_learn_timer < 300) return;       // удержание кнопки пульта шлёт тот же код
+    ir_codes[ir_learn] = code;
+    EEPROM.updateLong(IR_EEPROM + ir_learn * 4, code);
+  }
+  ir_learn_timer = millis();                           // и отсчёт IR_LEARN_TIMEOUT заново
+  if (++ir_learn >= IR_KEYS) irLearnStop();
+  else irLearnShow();
+}
+
+void irLearnShow() {
+  ledsClear();
+  fillLeds(0, min(ir_learn + 1, NUM_LEDS), ledsColor(PAL_FILL, CRGB::Green));
+  ledsShow();
+}
 #endif
 
 void autoLowPass() {
+  vuStop();
   // для режима VU
   delay(10);                                // ждём инициализации АЦП
   int thisMax = 0;                          // максимум
   int thisLevel;
   for (byte i = 0; i < 200; i++) {
+#if (ADC_STREAM == 1)
+    thisLevel = vuPeak(0);                  // делаем 200 измерений (максимум потока за VU_PEAK_WINDOW)
+#else
     thisLevel = analogRead(SOUND_R);        // делаем 200 измерений
+#endif
     if (thisLevel > thisMax)                // ищем максимумы
       thisMax = thisLevel;                  // запоминаем
     delay(4);                               // ждём 4мс
@@ -882,35 +1407,237 @@ void autoLowPass() {
 
   // для режима спектра
   thisMax = 0;
+  SPEKTR_LOW_PASS = 0;                      // замеряем без порога
   for (byte i = 0; i < 100; i++) {          // делаем 100 измерений
     analyzeAudio();                         // разбить в спектр
-    for (byte j = 2; j < 32; j++) {         // первые 2 канала - хлам
-      thisLevel = fht_log_out[j];
-      if (thisLevel > thisMax)              // ищем максимумы
-        thisMax = thisLevel;                // запоминаем
-    }
+    thisLevel = ((long)bandsMax() + (1 << LOG_FRAC) - 1) >> LOG_FRAC;   // первые 2 канала - хлам, в полосы не входят. Доли - вверх
+    if (thisLevel > thisMax)                // ищем максимумы
+      thisMax = thisLevel;                  // запоминаем
     delay(4);                               // ждём 4мс
   }
   SPEKTR_LOW_PASS = thisMax + LOW_PASS_FREQ_ADD;  // нижний порог как максимум тишины
+#if (BANDS_IIR == 1 && ADC_STREAM == 0)
+  thisMax = 0;                              // у фильтров полос свой порог: шкала та же, но шум шире
+  for (byte i = 0; i < 100; i++) {
+    analyzeBands();
+    for (byte j = 0; j < 3; j++)
+      if (band_level[j] > thisMax) thisMax = band_level[j];
+    delay(4);
+  }
+  BANDS_LOW_PASS = thisMax + LOW_PASS_FREQ_ADD;
+#endif
   if (EEPROM_LOW_PASS && !AUTO_LOW_PASS) {
     EEPROM.updateInt(70, LOW_PASS);
     EEPROM.updateInt(72, SPEKTR_LOW_PASS);
+    EEPROM.updateInt(74, BANDS_LOW_PASS);
   }
 }
 
 void analyzeAudio() {
+  fht_gate = (fht_log_t)min(SPEKTR_LOW_PASS, 255) << LOG_FRAC;
+  fht_decay = LIGHT_SMOOTH << LOG_FRAC;
+#if (ADC_STREAM == 1)
+  // окно - последние FHT_N кругов потока. Кольца стоят, пока из них читаем
+  ring_hold = true;
+  byte head = ring_head;
+#if (STEREO_SPECTRUM == 1)
+  for (int i = 0 ; i < FHT_N ; i++) fht_input_put(i, ring_l[(head + i) & (FHT_N - 1)]);
+  fht_run();
+  fht_mag_log_bands(fht_log_l, freq_f_l);
+  freq_max_l = bandsMax();
+#if (SPEKTR_OCTAVE == 1)
+  if (this_mode == 8) octaveSmooth(oct_f_l);
+#endif
+#endif
+  for (int i = 0 ; i < FHT_N ; i++) fht_input_put(i, ring_freq[(head + i) & (FHT_N - 1)]);
+  ring_hold = false;
+#elif (ADC_OVERSAMPLE > 1)
+  // выборки забираются по флагу ADIF, пока АЦП уже преобразует следующую
+  uint16_t integ1 = 0, integ2 = 0, comb1 = 0, comb2 = 0;
+  analogRead(SOUND_R_FREQ);               // вход и опорное напряжение
+  sbi(ADCSRA, ADATE);
+  sbi(ADCSRA, ADSC);
+  for (int i = -2; i < FHT_N; i++) {      // 2 первых выхода - разгон гребёнок, не берём
+    for (byte r = 0; r < ADC_OVERSAMPLE; r++) {
+      while (!bit_is_set(ADCSRA, ADIF));
+      sbi(ADCSRA, ADIF);                  // сброс флага записью 1
+      integ1 += ADC;
+      integ2 += integ1;
+    }
+    uint16_t this_comb = integ2 - comb1;
+    comb1 = integ2;
+    uint16_t sample = this_comb - comb2;
+    comb2 = this_comb;
+    if (i >= 0) fht_input_put(i, sample >> CIC_SHIFT);
+  }
+  cbi(ADCSRA, ADATE);
+  while (bit_is_set(ADCSRA, ADSC));       // дождаться последнего преобразования
+#else
   for (int i = 0 ; i < FHT_N ; i++) {
     int sample = analogRead(SOUND_R_FREQ);
-    fht_input[i] = sample; // put real data into bins
+    fht_input_put(i, sample);   // сразу с окном и на место после перестановки
   }
-  fht_window();  // window the data for better frequency response
-  fht_reorder(); // reorder the data before doing the fht
+#endif
   fht_run();     // process the data in the fht
-  fht_mag_log(); // take the output of the fht
+  fht_mag_log_bands(fht_spektr, freq_f);   // спектр, порог шумов, пики и полосы за один проход
+#if (SPEKTR_OCTAVE == 1)
+  if (this_mode == 8) octaveSmooth(oct_f);
+#endif
+}
+
+#if (SPEKTR_OCTAVE == 1)
+// октавы последнего fht_run(): порог шумов и плавный спад, как у полос FHT
+void octaveSmooth(byte *oct) {
+  fht_mag_octave();
+  for (byte o = 0; o < OCT_NUM; o++) {
+    byte this_val = fht_oct_out[o + OCT_FIRST];
+    if (this_val < SPEKTR_LOW_PASS) this_val = 0;
+    if (this_val > oct[o]) oct[o] = this_val;
+    else oct[o] = (oct[o] > LIGHT_SMOOTH) ? oct[o] - LIGHT_SMOOTH : 0;
+  }
+}
+
+// яркость октав по общей АРУ спектра (freq_max_f в шкале fht_spektr)
+void octaveBright(byte *oct, byte *bright) {
+  long oct_max = max((long)freq_max_f >> LOG_FRAC, 1);
+  for (byte o = 0; o < OCT_NUM; o++)
+    bright[o] = constrain(map(oct[o], 0, oct_max, 0, 255), 0, 255);
+}
+
+// яркость в дробной позиции pos (16.16) между соседними октавами
+byte octaveLerp(byte *bright, uint32_t pos) {
+  byte o = pos >> 16;
+  if (o >= OCT_NUM - 1) return bright[OCT_NUM - 1];
+  return lerp8by8(bright[o], bright[o + 1], pos >> 8);
+}
+#endif
+
+// самая громкая полоса FHT последнего fht_mag_log_bands (без 0 и 1)
+fht_log_t bandsMax() {
+  fht_log_t this_max = 0;
+  for (byte b = 0; b < LOG_BANDS; b++)
+    if (fht_band_max[b] > this_max) this_max = fht_band_max[b];
+  return this_max;
+}
+
+// ----- огибающая громкости в прерывании АЦП
+void vuStart() {
+  if (ADC_STREAM || vu_running) return;   // поток и так копит огибающую
+  analogRead(SOUND_R);                      // опорное напряжение и вход
+  sbi(ADCSRA, ADPS1);                       // делитель 128
+  vu_ch = 0;
+  sbi(ADCSRA, ADIE);
+  sbi(ADCSRA, ADSC);
+  vu_running = true;
+}
+void vuStop() {
+  if (!vu_running) return;
+  cbi(ADCSRA, ADIE);
+  while (bit_is_set(ADCSRA, ADSC));         // дождаться последнего преобразования
+  cbi(ADCSRA, ADPS1);                       // обратно делитель 32
+  vu_running = false;
+}
+
+static inline void vuAccumulate(byte ch, uint16_t sample) {
+  volatile VuEnvelope &e = vu_env[ch];
+  e.square += (uint32_t)sample * sample - (e.square >> VU_RMS_SHIFT);
+  if (sample > e.peak_now) e.peak_now = sample;
+  if (++e.count >= VU_PEAK_SAMPLES) {
+    e.peak_last = e.peak_now;
+    e.peak_now = 0;
+    e.count = 0;
+  }
+}
+
+#if (ADC_STREAM == 1)
+void adcStreamBegin() {
+#if (MONO == 1)
+  const byte adc_pins[ADC_SLOTS] = {SOUND_R, SOUND_R_FREQ};
+#else
+  const byte adc_pins[ADC_SLOTS] = {SOUND_R, SOUND_L, SOUND_R_FREQ};
+#endif
+  for (byte i = 0; i < ADC_SLOTS; i++) adc_mux[i] = ADC_CHANNEL(adc_pins[i]) & 0x07;
+  analogRead(SOUND_R);                      // опорное напряжение
+  ADCSRA = (ADCSRA & 0xF8) | _BV(ADPS2) | _BV(ADPS1);   // делитель 64
+  ADCSRB &= 0xF8;                           // автозапуск по окончании преобразования
+  ADMUX = (ADMUX & 0xE0) | adc_mux[0];
+  adc_slot = 0;
+  ADCSRA |= _BV(ADATE) | _BV(ADIE) | _BV(ADSC);
+  delayMicroseconds(10);                    // вход первого преобразования защёлкнут
+  ADMUX = (ADMUX & 0xE0) | adc_mux[1];      // вход второго
+}
+
+// преобразования идут без остановки, поэтому ADMUX задаёт вход не для следующего, а для следующего за ним
+ISR(ADC_vect) {
+  uint16_t sample = ADC;
+  byte slot = adc_slot;                     // вход готовой выборки
+  if (++adc_slot >= ADC_SLOTS) adc_slot = 0;
+  byte next = (adc_slot + 1 < ADC_SLOTS) ? adc_slot + 1 : 0;
+  ADMUX = (ADMUX & 0xE0) | adc_mux[next];
+
+  if (slot == SLOT_FREQ) {
+    if (!ring_hold) {
+      ring_freq[ring_head] = sample;
+      ring_head = (ring_head + 1) & (FHT_N - 1);
+      adc_clock++;
+    }
+  } else {
+    vuAccumulate(slot, sample);
+#if (STEREO_SPECTRUM == 1)
+    if (slot == 1 && !ring_hold) ring_l[ring_head] = sample;
+#endif
+  }
+}
+#else
+ISR(ADC_vect) {
+  uint16_t sample = ADC;
+  byte ch = vu_ch;
+  if (!MONO) {                              // следующая выборка - с другого канала
+    vu_ch ^= 1;
+    ADMUX = (ADMUX & 0xE0) | ((vu_ch ? ADC_CHANNEL(SOUND_L) : ADC_CHANNEL(SOUND_R)) & 0x07);
+  }
+  sbi(ADCSRA, ADSC);
+  vuAccumulate(ch, sample);
+}
+#endif
+
+// громкость канала в шкале analogRead
+float vuLevel(byte ch) {
+#if (VU_ENVELOPE == 1)
+  noInterrupts();
+  uint32_t square = vu_env[ch].square;
+  interrupts();
+  return sqrt((float)(square >> VU_RMS_SHIFT)) * 2;   // у однополупериодного синуса RMS = пик / 2
+#else
+  return vuPeak(ch);
+#endif
+}
+uint16_t vuPeak(byte ch) {
+  noInterrupts();
+  uint16_t peak = max(vu_env[ch].peak_now, vu_env[ch].peak_last);
+  interrupts();
+  return peak;
+}
+
+// нужен ли кадру полный спектр FHT: 8 режим и водопад рисуют все частоты
+boolean fullSpectrum() {
+  return BANDS_IIR == 0 || ADC_STREAM == 1 || this_mode == 8 || this_mode == 10;   // фильтрам полос нужен свой захват
 }
 
 void buttonTick() {
   butt1.tick();  // обязательная функция отработки. Должна постоянно опрашиваться
+#if REMOTE_TYPE != 0
+  if (ir_learn >= 0) {                               // в режиме обучения пульта
+    if (butt1.hasClicks()) irLearn(0);               // клик - пропустить кнопку
+    if (butt1.isHolded()) {                          // удержание - закончить обучение
+      ir_learn = IR_KEYS;
+      irLearn(0);
+    }
+    return;
+  }
+  if (butt1.isTriple()) irLearnStart();              // тройное нажатие - обучение пульта
+#endif
+
   if (butt1.isSingle())                              // если единичное нажатие
     if (++this_mode >= MODE_AMOUNT) this_mode = 0;   // изменить режим
 
@@ -920,55 +1647,28 @@ void buttonTick() {
 }
 void fullLowPass() {
   digitalWrite(MLED_PIN, MLED_ON);   // включить светодиод
-  FastLED.setBrightness(0); // погасить ленту
-  FastLED.clear();          // очистить массив пикселей
-  FastLED.show();           // отправить значения на ленту
+  ledsBrightness(0);        // погасить ленту
+  ledsClear();              // очистить массив пикселей
+  ledsShow();               // отправить значения на ленту
   delay(500);               // подождать чутка
   autoLowPass();            // измерить шумы
   delay(500);               // подождать
-  FastLED.setBrightness(BRIGHTNESS);  // вернуть яркость
+  ledsBrightness(BRIGHTNESS);         // вернуть яркость
   digitalWrite(MLED_PIN, !MLED_ON);    // выключить светодиод
 }
 void updateEEPROM() {
   EEPROM.updateByte(1, this_mode);
   EEPROM.updateByte(2, freq_strobe_mode);
   EEPROM.updateByte(3, light_mode);
-  EEPROM.updateInt(4, RAINBOW_STEP);
-  EEPROM.updateFloat(8, MAX_COEF_FREQ);
-  EEPROM.updateInt(12, STROBE_PERIOD);
-  EEPROM.updateInt(16, LIGHT_SAT);
-  EEPROM.updateFloat(20, RAINBOW_STEP_2);
-  EEPROM.updateInt(24, HUE_START);
-  EEPROM.updateFloat(28, SMOOTH);
-  EEPROM.updateFloat(32, SMOOTH_FREQ);
-  EEPROM.updateInt(36, STROBE_SMOOTH);
-  EEPROM.updateInt(40, LIGHT_COLOR);
-  EEPROM.updateInt(44, COLOR_SPEED);
-  EEPROM.updateInt(48, RAINBOW_PERIOD);
-  EEPROM.updateInt(52, RUNNING_SPEED);
-  EEPROM.updateInt(56, HUE_STEP);
-  EEPROM.updateInt(60, EMPTY_BRIGHT);
+  for (byte i = 0; i < PARAM_AMOUNT; i++) paramEEPROM(i, true);
   if (KEEP_STATE) EEPROM.updateByte(64, ONstate);
 }
 void readEEPROM() {
   this_mode = EEPROM.readByte(1);
+  if (this_mode >= MODE_AMOUNT) this_mode = 0;    // режим из прошивки с другим набором режимов
   freq_strobe_mode = EEPROM.readByte(2);
   light_mode = EEPROM.readByte(3);
-  RAINBOW_STEP = EEPROM.readInt(4);
-  MAX_COEF_FREQ = EEPROM.readFloat(8);
-  STROBE_PERIOD = EEPROM.readInt(12);
-  LIGHT_SAT = EEPROM.readInt(16);
-  RAINBOW_STEP_2 = EEPROM.readFloat(20);
-  HUE_START = EEPROM.readInt(24);
-  SMOOTH = EEPROM.readFloat(28);
-  SMOOTH_FREQ = EEPROM.readFloat(32);
-  STROBE_SMOOTH = EEPROM.readInt(36);
-  LIGHT_COLOR = EEPROM.readInt(40);
-  COLOR_SPEED = EEPROM.readInt(44);
-  RAINBOW_PERIOD = EEPROM.readInt(48);
-  RUNNING_SPEED = EEPROM.readInt(52);
-  HUE_STEP = EEPROM.readInt(56);
-  EMPTY_BRIGHT = EEPROM.readInt(60);
+  for (byte i = 0; i < PARAM_AMOUNT; i++) paramEEPROM(i, false);
   if (KEEP_STATE) ONstate = EEPROM.readByte(64);
 }
 void eepromTick() {
@@ -979,3 +1679,39 @@ void eepromTick() {
       updateEEPROM();
     }
 }
+
+// ----- вывод на ленту, один интерфейс для всех LED_DRIVER
+void ledsBegin() {
+#if (LED_DRIVER == 0)
+#if (LED_INDEXED == 1)
+  FastLED.addLeds<WS2811, LED_PIN, GRB>(NULL, NUM_LEDS).setLedsIndexed(leds, ledsPal, NUM_LEDS).setCorrection( TypicalLEDStrip );
+#else
+  FastLED.addLeds<WS2811, LED_PIN, GRB>(leds, NUM_LEDS).setCorrection( TypicalLEDStrip );
+#endif
+  if (CURRENT_LIMIT > 0) FastLED.setMaxPowerInVoltsAndMilliamps(5, CURRENT_LIMIT);
+#elif (LED_DRIVER == 1)
+  strip.begin();
+#endif
+  ledsBrightness(BRIGHTNESS);
+}
+void ledsBrightness(byte bright) {
+#if (LED_DRIVER == 0)
+  FastLED.setBrightness(bright);
+#elif (LED_DRIVER == 1)
+  strip.setBrightness(bright);    // применяется в setPixelColor, то есть при следующем ledsShow()
+#endif
+}
+void ledsShow() {
+#if (LED_DRIVER == 0)
+  zigzagPass();
+  FastLED.show();
+  zigzagPass();
+#elif (LED_DRIVER == 1)
+  for (int i = 0; i < NUM_LEDS; i++)   // у NeoPixel свой буфер, переписываем в него leds[] (сразу со змейкой)
+    strip.setPixelColor(zigzag(i), leds[i].r, leds[i].g, leds[i].b);
+  strip.show();
+#endif
+}
+void ledsClear() {
+  memset(leds, 0, sizeof(leds));
+}
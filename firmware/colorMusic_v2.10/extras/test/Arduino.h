@@ -0,0 +1,21 @@
+// заглушка Arduino.h для проверки bands_iir.h на компьютере: АЦП отдаёт выборки генератора теста
+#ifndef Arduino_h
+#define Arduino_h
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PI 3.1415926535897932384626433832795
+#define _BV(bit) (1 << (bit))
+#define bit_is_set(sfr, bit) ((sfr) & _BV(bit) & 0)   // преобразование готово сразу
+#define ADSC 6
+
+extern uint8_t ADCSRA;
+int test_adc();                 // следующая выборка генератора, 0-1023
+#define ADC (test_adc())
+inline int analogRead(uint8_t) { return test_adc(); }
+
+#endif
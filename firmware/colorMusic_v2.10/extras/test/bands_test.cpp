@@ -0,0 +1,157 @@
+/*
+  Проверка фильтров полос (bands_iir.h) на компьютере, без платы: АЦП подменён генератором
+  (Arduino.h в этой папке). Одни и те же тоны и шум подаются на analyzeBands() и на модель FHT
+  прошивки (64 выборки с того же входа, окно Ханна как у fht_input_put(), деление на FHT_N по
+  ступеням, 8 * log2 мощности бина, максимум по бинам fht_bands). Проверяется, что band_level
+  после поправки band_offset стоит на шкале fht_log_out, и печатаются шумовые пороги обоих путей.
+  Модель FHT считается в double, ассемблер библиотеки здесь не исполняется.
+  Сборка и запуск из этой папки:
+  g++ -std=gnu++11 -Wall -I. -I../.. bands_test.cpp -o bands_test && ./bands_test
+*/
+#include <stdio.h>
+#include "Arduino.h"
+#define SOUND_R_FREQ 17
+#include "bands_iir.h"
+
+#define FHT_N 64
+const uint8_t fht_bands[] = {2, 6, 11, 32};   // как в прошивке при ADC_OVERSAMPLE 1
+
+uint8_t ADCSRA;
+static int fails;
+
+#define CHECK(x) do { if (!(x)) { printf("%s:%d: %s (%.0f Hz)\n", __FILE__, __LINE__, #x, tone_freq); fails++; } } while (0)
+
+// генератор: синус вокруг середины шкалы АЦП плюс равномерный шум
+double tone_amp, tone_freq, tone_phase, noise_amp;
+long tone_n;
+uint32_t rnd = 1;
+
+int test_adc() {
+  rnd = rnd * 1103515245 + 12345;
+  double v = 512 + tone_amp * sin(2 * PI * tone_freq * tone_n++ / BANDS_FS + tone_phase)
+             + noise_amp * (((rnd >> 8) & 0xFFFF) / 32768.0 - 1);
+  long s = lround(v);
+  return s < 0 ? 0 : s > 1023 ? 1023 : s;
+}
+
+void setTone(double freq, double amp, double noise = 0) {
+  tone_freq = freq;
+  tone_amp = amp;
+  noise_amp = noise;
+  tone_phase = 0.3;
+  tone_n = 0;
+  for (byte i = 0; i < 2; i++) svf_low[i] = svf_band[i] = 0;
+  for (byte i = 0; i < 20; i++) analyzeBands();   // фильтры устоялись
+}
+
+// полосы FHT прошивки по следующим FHT_N выборкам, шкала fht_log_out без долей
+double fht_level[3];
+void fhtBands() {
+  double x[FHT_N];
+  for (int i = 0; i < FHT_N; i++) {
+    double hann = 0.5 - 0.5 * cos(2 * PI * i / (FHT_N - 1));
+    int32_t w = (hann * 32768 + 0.5 >= 32767) ? 32767 : hann * 32768 + 0.5;   // fht_window_q15()
+    x[i] = (test_adc() * w) >> 15;
+  }
+  for (byte b = 0; b < 3; b++) fht_level[b] = 0;
+  for (int k = fht_bands[0]; k < fht_bands[3]; k++) {
+    double h1 = 0, h2 = 0;                    // H[k] и H[N - k]
+    for (int i = 0; i < FHT_N; i++) {
+      double a = 2 * PI * i * k / FHT_N;
+      h1 += x[i] * (cos(a) + sin(a));
+      h2 += x[i] * (cos(a) - sin(a));
+    }
+    h1 /= FHT_N;
+    h2 /= FHT_N;
+    double power = h1 * h1 + h2 * h2;
+    double level = power >= 1 ? 8 * log2(power) : 0;
+    for (byte b = 0; b < 3; b++)
+      if (k >= fht_bands[b] && k < fht_bands[b + 1] && level > fht_level[b]) fht_level[b] = level;
+  }
+}
+
+// тоны внутри полос (без краёв, где полосы перекрываются), 20-400 единиц АЦП:
+// средняя разница с FHT около нуля, каждая - в пределах половины октавы по амплитуде
+void testToneScale() {
+  const double lo[3] = {1350, 3800, 6800}, hi[3] = {2800, 5800, 17000};
+  for (byte b = 0; b < 3; b++) {
+    double sum = 0, dmin = 255, dmax = -255;
+    int count = 0;
+    for (double amp = 20; amp <= 400; amp *= 2) {
+      for (double f = lo[b]; f < hi[b]; f *= 1.03) {
+        setTone(f, amp);
+        fhtBands();
+        double d = band_level[b] - fht_level[b];
+        CHECK(d > -8 && d < 8);
+        sum += d;
+        if (d < dmin) dmin = d;
+        if (d > dmax) dmax = d;
+        count++;
+      }
+    }
+    printf("band %d: band_level - FHT  mean %+5.1f  min %+5.1f  max %+5.1f  (%d tones)\n",
+           b, sum / count, dmin, dmax, count);
+    CHECK(sum / count > -1.5 && sum / count < 1.5);   // band_offset[b] не уехал
+  }
+}
+
+// тон в середине полосы FHT (бины 3.5, 8 и 21) громче всего в своей полосе. Фильтры второго порядка
+// шире бинов с окном, соседняя полоса ниже своей всего на 7-9 (пол-октавы по амплитуде), у FHT - на 80 и больше
+const double centre[3] = {2078, 4750, 12470};
+void testToneBand() {
+  for (byte b = 0; b < 3; b++) {
+    setTone(centre[b], 200);
+    fhtBands();
+    printf("%5.0f Hz: band_level %3d %3d %3d  FHT %3.0f %3.0f %3.0f\n", centre[b],
+           band_level[0], band_level[1], band_level[2], fht_level[0], fht_level[1], fht_level[2]);
+    for (byte j = 0; j < 3; j++)
+      if (j != b) CHECK(band_level[b] >= band_level[j] + 4);
+  }
+}
+
+// тишина - нули, без шума внизу шкалы
+void testSilence() {
+  setTone(1000, 0);
+  for (byte b = 0; b < 3; b++) CHECK(band_level[b] == 0);
+}
+
+// порог как в autoLowPass(): максимум по 100 кадрам шума + LOW_PASS_FREQ_ADD. Шум фильтров и FHT
+// растёт по-разному (у FHT внизу утечка постоянной составляющей через окно), поэтому порогов два.
+// Под своим порогом шум почти всегда гасится, тон в 4 раза громче шума - проходит
+void testNoiseFloor() {
+  for (double noise = 4; noise <= 32; noise *= 2) {
+    setTone(1000, 0, noise);
+    int bands_max = 0;
+    double fht_max = 0;
+    for (byte i = 0; i < 100; i++) {
+      analyzeBands();
+      fhtBands();
+      for (byte b = 0; b < 3; b++) {
+        if (band_level[b] > bands_max) bands_max = band_level[b];
+        if (fht_level[b] > fht_max) fht_max = fht_level[b];
+      }
+    }
+    int bands_low_pass = bands_max + 3;
+    printf("noise +-%2.0f: BANDS_LOW_PASS %3d  SPEKTR_LOW_PASS %3.0f\n", noise, bands_low_pass, ceil(fht_max) + 3);
+    int passed = 0;
+    for (byte i = 0; i < 100; i++) {
+      analyzeBands();
+      for (byte b = 0; b < 3; b++) passed += band_level[b] >= bands_low_pass;
+    }
+    CHECK(passed <= 6);
+    for (byte b = 0; b < 3; b++) {
+      setTone(centre[b], noise * 4, noise);
+      CHECK(band_level[b] >= bands_low_pass);
+    }
+  }
+}
+
+int main() {
+  testToneScale();
+  testToneBand();
+  testSilence();
+  testNoiseFloor();
+  if (fails) printf("%d checks failed\n", fails);
+  else printf("ok\n");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+/*
+  Замер времени кадра шумового режима (noise_mode.h) на компьютере, без платы. Код режима и
+  библиотеки (noise.cpp, hsv2rgb.cpp) собирается как есть, через заглушки FastLED из
+  libraries/FastLED-master/extras/test. Сравниваются:
+  - инкрементальный расчёт прошивки: noiseFrame() каждый кадр, noiseBase() раз в NOISE_BASE_PERIOD
+    (каждый 4 кадр при 100 FPS)
+  - полный расчёт: обе октавы на каждый светодиод каждый кадр, без опорных точек
+  Печатаются мкс/кадр, число вызовов шума на кадр и наибольшая длина ленты для 100 FPS: вместе с
+  выводом на WS2812 (30 мкс на светодиод) и по одному расчёту. Время - процессора компьютера, не AVR: на плате его
+  меряет firmware/NoiseBench, а число вызовов шума на кадр от платформы не зависит.
+  Сборка и запуск из этой папки:
+  g++ -std=gnu++11 -Os -Wall -Wno-class-memaccess -I. -I../.. -I../../../../libraries/FastLED-master/extras/test -I../../../../libraries/FastLED-master noise_bench.cpp -o noise_bench && ./noise_bench
+*/
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include "Arduino.h"
+#include "host.h"
+#include "noise.cpp"
+#include "hsv2rgb.cpp"
+using std::max;
+
+#define NUM_LEDS 2000             // наибольшая длина замера, NOISE_POINTS < 256
+#define FRAME_US 10000            // 100 FPS
+#define SHOW_US_PER_LED 30
+#define FRAMES 2000
+
+CRGB leds[NUM_LEDS];
+byte HUE_START = 0;
+#include "noise_mode.h"
+
+uint8_t ADCSRA;
+int test_adc() { return 512; }
+
+// полный расчёт тех же октав: масштаб на светодиод в NOISE_STEP раз меньше, чем на опорную точку
+void noiseFrameFull(int num, byte bass, byte mid, byte high) {
+  static byte base[NUM_LEDS], val[NUM_LEDS];
+  noise_base_t += (400 + (mid << 2)) / 4;
+  noise_t += 3 + (bass >> 5);
+  memset(base, 0, num);
+  memset(val, 0, num);
+  int scale = 12 + (mid >> 4);
+  for (int i = 0; i < num; i += 250) {     // fill_raw_noise берёт до 255 точек
+    byte n = std::min(num - i, 250);
+    fill_raw_noise16into8(base + i, n, 1, (uint32_t)i * 1000, 1000, noise_base_t);
+    fill_raw_noise8(val + i, n, 1, i * scale, scale, noise_t);
+  }
+  byte energy = max(max(bass, mid), high);
+  byte hue_shift = HUE_START + (high >> 2);
+  for (int i = 0; i < num; i++) {
+    byte v = qsub8(avg8(base[i], val[i]), 64);
+    ((CHSV *)leds)[i] = CHSV(hue_shift + base[i], 255, scale8(qadd8(v, v), energy));
+  }
+  hsv2rgb_rainbow((CHSV *)leds, leds, num);
+}
+
+// полосы для кадра f: медленно и по-разному меняются, как громкость музыки
+byte band(int f, byte b) {
+  return 128 + (sin8(f * (3 + b) + b * 85) >> 1);
+}
+
+// мкс на кадр
+double bench(int num, bool full) {
+  noise_base_t = noise_t = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < FRAMES; f++) {
+    if (full) {
+      noiseFrameFull(num, band(f, 0), band(f, 1), band(f, 2));
+    } else {
+      if ((f & 3) == 0) noiseBase(num, band(f, 1));
+      noiseFrame(num, band(f, 0), band(f, 1), band(f, 2));
+    }
+    asm volatile("" : : "r"(leds) : "memory");
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+}
+
+// сколько светодиодов укладывается в кадр 100 FPS: с выводом на ленту и только расчёт
+long maxLeds(double us, int num, int show_us) {
+  return FRAME_US * num / (us + show_us * num);
+}
+
+int main() {
+  const int lengths[] = {60, 120, 300, 410, 1000, 2000};
+  double full_us = 0, inc_us = 0;
+  int full_num = 0;
+  for (byte n = 0; n < sizeof(lengths) / sizeof(int); n++) {
+    int num = lengths[n];
+    double full = bench(num, true), incremental = bench(num, false);
+    // у инкрементального крупная октава - каждый 4 кадр
+    printf("%4d светодиодов: полный %6.2f мкс/кадр (%4d вызовов шума), инкрементальный %6.2f мкс/кадр (%5.1f), x%.1f\n",
+           num, full, 2 * num, incremental, NOISE_POINTS(num) * 1.25, full / incremental);
+    full_us = full;
+    inc_us = incremental;
+    full_num = num;
+  }
+  printf("до светодиодов при 100 FPS: с выводом на WS2812 полный %ld, инкрементальный %ld; "
+         "только расчёт полный %ld, инкрементальный %ld\n",
+         maxLeds(full_us, full_num, SHOW_US_PER_LED), maxLeds(inc_us, full_num, SHOW_US_PER_LED),
+         maxLeds(full_us, full_num, 0), maxLeds(inc_us, full_num, 0));
+  return 0;
+}
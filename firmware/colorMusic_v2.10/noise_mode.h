@@ -0,0 +1,47 @@
+// шум 9 режима: опорные точки через NOISE_STEP светодиодов, между ними линейная интерполяция.
+// Крупная октава (тон и основа яркости) лежит в кэше noise_base и пересчитывается раз в NOISE_BASE_PERIOD мс
+// (noiseBase), каждый кадр считается только мелкая октава, бегущая во времени (noiseFrame).
+// Отдельный файл, чтобы время кадра можно было замерить на компьютере (extras/test)
+#ifndef noise_mode_h
+#define noise_mode_h
+
+#define NOISE_STEP 8              // степень двойки
+#define NOISE_POINTS(num) (((num) + NOISE_STEP - 1) / NOISE_STEP + 1)
+#define NOISE_BASE_PERIOD 40
+static_assert((NOISE_STEP & (NOISE_STEP - 1)) == 0, "NOISE_STEP must be a power of two");
+static_assert(NOISE_POINTS(NUM_LEDS) < 256, "too many noise points, increase NOISE_STEP");
+
+byte noise_base[NOISE_POINTS(NUM_LEDS)];
+uint32_t noise_base_t;
+uint16_t noise_t;
+
+// крупная октава на num светодиодов, середина ускоряет её течение
+void noiseBase(int num, byte mid) {
+  noise_base_t += 400 + (mid << 2);
+  memset(noise_base, 0, NOISE_POINTS(num));
+  fill_raw_noise16into8(noise_base, NOISE_POINTS(num), 1, 0, NOISE_STEP * 1000, noise_base_t);
+}
+
+// кадр на num светодиодов: мелкая октава, бас ускоряет время, середина мельчит узор.
+// Общая яркость - самая громкая полоса, верх сдвигает тон
+void noiseFrame(int num, byte bass, byte mid, byte high) {
+  byte noise_val[NOISE_POINTS(NUM_LEDS)];
+  noise_t += 3 + (bass >> 5);
+  memset(noise_val, 0, NOISE_POINTS(num));
+  fill_raw_noise8(noise_val, NOISE_POINTS(num), 1, 0, NOISE_STEP * (12 + (mid >> 4)), noise_t);
+  for (byte p = 0; p < NOISE_POINTS(num); p++) {
+    byte v = qsub8(avg8(noise_base[p], noise_val[p]), 64);   // растягиваем контраст
+    noise_val[p] = qadd8(v, v);
+  }
+  byte energy = max(max(bass, mid), high);
+  byte hue_shift = HUE_START + (high >> 2);
+  for (int i = 0; i < num; i++) {
+    byte p = i / NOISE_STEP;
+    byte frac = (i % NOISE_STEP) * (256 / NOISE_STEP);
+    ((CHSV *)leds)[i] = CHSV(hue_shift + lerp8by8(noise_base[p], noise_base[p + 1], frac), 255,
+                             scale8(lerp8by8(noise_val[p], noise_val[p + 1], frac), energy));
+  }
+  hsv2rgb_rainbow((CHSV *)leds, leds, num);
+}
+
+#endif
@@ -27,6 +27,10 @@ modded 7.7.14 - fixed progmem for new avr-gcc (thanks to forum user kirill9617)
   #define WINDOW 1
 #endif
 
+#ifndef WINDOW_FUNC // which window fht_window() uses: 0 hann, 1 blackman-harris, 2 flat-top
+  #define WINDOW_FUNC 0
+#endif
+
 #ifndef OCT_NORM // wether using the octave normilization
   #define OCT_NORM 1
 #endif
@@ -39,6 +43,14 @@ modded 7.7.14 - fixed progmem for new avr-gcc (thanks to forum user kirill9617)
   #define LOG_OUT 0
 #endif
 
+#ifndef LOG_OUT16 // wether using the 16b log output function or not
+  #define LOG_OUT16 0
+#endif
+
+#ifndef LOG_BANDS // number of bands for fht_mag_log_bands(), 0 turns it off
+  #define LOG_BANDS 0
+#endif
+
 #ifndef LIN_OUT // wether using the linear output function or not
   #define LIN_OUT 0
 #endif
@@ -102,16 +114,55 @@ extern const int16_t __attribute__((used)) _cas_constants[] PROGMEM = {
   };
 #endif
 
-#if ((LOG_OUT == 1)||(OCTAVE == 1))
+#if ((LOG_OUT == 1)||(OCTAVE == 1)||((LOG_BANDS > 0)&&(LOG_OUT16 == 0)))
   extern const uint8_t __attribute__((used)) _log_table[] PROGMEM = {
     #include <decibel.inc>
   };
 #endif
 
+#if (LOG_OUT16 == 1)
+  // the same table for fht_mag_log16(), as 2 * value, plus 1 where the next
+  // entry is one higher. only then the byte below the looked up one is a
+  // fraction of a step, else it is dropped. 256 aligned, so the lookup
+  // needs no add
+  constexpr uint8_t _fht_log8[] = {
+    #include <decibel.inc>
+    64 // 8*log2(256), the entry after the last one
+  };
+  #define _FHT_L1(m) (uint8_t)(2 * _fht_log8[m] + (_fht_log8[(m) + 1] > _fht_log8[m]))
+  #define _FHT_L4(m) _FHT_L1(m), _FHT_L1((m) + 1), _FHT_L1((m) + 2), _FHT_L1((m) + 3)
+  #define _FHT_L16(m) _FHT_L4(m), _FHT_L4((m) + 4), _FHT_L4((m) + 8), _FHT_L4((m) + 12)
+  #define _FHT_L64(m) _FHT_L16(m), _FHT_L16((m) + 16), _FHT_L16((m) + 32), _FHT_L16((m) + 48)
+  extern const uint8_t __attribute__((used, aligned(256))) _log_table16[] PROGMEM = {
+    _FHT_L64(0), _FHT_L64(64), _FHT_L64(128), _FHT_L64(192)
+  };
+#endif
+
 #if (LOG_OUT == 1)
   uint8_t __attribute__((used)) fht_log_out[(FHT_N/2)]; // FHT log output magintude buffer
 #endif
 
+#if (LOG_OUT16 == 1)
+  uint16_t __attribute__((used)) fht_log_out16[(FHT_N/2)]; // FHT 16b log output magintude buffer
+#endif
+
+#if (LOG_BANDS > 0)
+  #if (LOG_OUT16 == 1) // bands work on the 16b log values of fht_mag_log16()
+    typedef uint16_t fht_log_t;
+    typedef uint32_t fht_flux_t;
+  #else
+    typedef uint8_t fht_log_t;
+    typedef uint16_t fht_flux_t;
+  #endif
+  fht_log_t __attribute__((used)) fht_gate; // bins below this come out as 0
+  fht_log_t __attribute__((used)) fht_decay; // how much the peak hold falls per call
+  fht_log_t __attribute__((used)) fht_band_max[(LOG_BANDS)]; // loudest bin of each band
+  fht_flux_t __attribute__((used)) fht_band_flux[(LOG_BANDS)]; // sum of bin rises of each band
+  // band edges, LOG_BANDS + 1 bin numbers, defined in the sketch: band b is
+  // bins fht_bands[b] to fht_bands[b + 1] - 1
+  extern const uint8_t fht_bands[];
+#endif
+
 #if (LIN_OUT == 1)
   extern const uint8_t __attribute__((used)) _lin_table[] PROGMEM = {
     #include <sqrtlookup16.inc>
@@ -130,18 +181,62 @@ extern const int16_t __attribute__((used)) _cas_constants[] PROGMEM = {
   uint8_t __attribute__((used)) fht_oct_out[(LOG_N)]; // FHT octave output magintude buffer
 #endif
 
+// window functions are generated at compile time from their cosine sums, so
+// changing WINDOW_FUNC or FHT_N needs no new tables. these are constexpr and
+// also usable at run time (slow, float), for example to compare windows.
+#define _FHT_PI 3.14159265358979
+
+// taylor series for cos(), 12 terms are plenty for x in [-pi, pi]
+constexpr double fht_cos_series(double x2, double term, uint8_t k) {
+  return (k == 12) ? 0 : term + fht_cos_series(x2, -term * x2 / ((2 * k + 1) * (2 * k + 2)), k + 1);
+}
+
+// cos() for x >= -pi, reduced to [-pi, pi] first
+constexpr double fht_cos(double x) {
+  return (x > _FHT_PI) ? fht_cos(x - 2 * _FHT_PI) : fht_cos_series(x * x, 1.0, 0);
+}
+
+// window value at sample n of N, peak is 1.0 in the middle
+//  0 - hann: narrow main lobe (4 bins), sidelobes -31dB
+//  1 - 4 term blackman-harris: wider main lobe (8 bins), sidelobes -92dB
+//  2 - flat-top: widest main lobe (10 bins), flat peak so amplitude is right
+//      even between bins, sidelobes -93dB. dips a little below zero at the ends
+constexpr double fht_window_shape(uint8_t func, uint16_t n, uint16_t N) {
+  return (func == 1) ?
+      0.35875 - 0.48829 * fht_cos(2 * _FHT_PI * n / (N - 1))
+      + 0.14128 * fht_cos(4 * _FHT_PI * n / (N - 1))
+      - 0.01168 * fht_cos(6 * _FHT_PI * n / (N - 1)) :
+    (func == 2) ?
+      0.21557895 - 0.41663158 * fht_cos(2 * _FHT_PI * n / (N - 1))
+      + 0.277263158 * fht_cos(4 * _FHT_PI * n / (N - 1))
+      - 0.083578947 * fht_cos(6 * _FHT_PI * n / (N - 1))
+      + 0.006947368 * fht_cos(8 * _FHT_PI * n / (N - 1)) :
+    0.5 - 0.5 * fht_cos(2 * _FHT_PI * n / (N - 1));
+}
+
+// 16b signed format for fht_window(), rounded to nearest. hann comes out
+// the same as the old hann_N.inc tables
+constexpr int16_t fht_window_q15(double w) {
+  return (w * 32768 + 0.5 >= 32767) ? 32767 :
+    (w < 0) ? -(int16_t)(-w * 32768 + 0.5) : (int16_t)(w * 32768 + 0.5);
+}
+
 #if (WINDOW == 1) // window functions are in 16b signed format
+  #define _FHT_W1(n) fht_window_q15(fht_window_shape(WINDOW_FUNC, (n), FHT_N))
+  #define _FHT_W4(n) _FHT_W1(n), _FHT_W1((n) + 1), _FHT_W1((n) + 2), _FHT_W1((n) + 3)
+  #define _FHT_W16(n) _FHT_W4(n), _FHT_W4((n) + 4), _FHT_W4((n) + 8), _FHT_W4((n) + 12)
+  #define _FHT_W64(n) _FHT_W16(n), _FHT_W16((n) + 16), _FHT_W16((n) + 32), _FHT_W16((n) + 48)
   extern const int16_t __attribute__((used)) _window_func[] PROGMEM = {
   #if (FHT_N ==  256)
-    #include <hann_256.inc>
+    _FHT_W64(0), _FHT_W64(64), _FHT_W64(128), _FHT_W64(192)
   #elif (FHT_N ==  128)
-    #include <hann_128.inc>
+    _FHT_W64(0), _FHT_W64(64)
   #elif (FHT_N ==  64)
-    #include <hann_64.inc>
+    _FHT_W64(0)
   #elif (FHT_N ==  32)
-    #include <hann_32.inc>
+    _FHT_W16(0), _FHT_W16(16)
   #elif (FHT_N ==  16)
-    #include <hann_16.inc>
+    _FHT_W16(0)
   #endif
   };
 #endif
@@ -847,6 +942,522 @@ static inline void fht_mag_log(void) {
   );
 }
 
+#if (LOG_OUT16 == 1)
+static inline void fht_mag_log16(void) {
+  // save registers that are getting clobbered
+  // avr-gcc requires r2:r17,r28:r29, and r1 cleared
+  asm volatile (
+  "push r2 \n"
+  "push r3 \n"
+  "push r4 \n"
+  "push r5 \n"
+  "push r6 \n"
+  "push r7 \n"
+  "push r8 \n"
+  "push r9 \n"
+  "push r15 \n"
+  "push r16 \n"
+  "push r17 \n"
+  "push r28 \n"
+  "push r29 \n"
+  );
+
+  // this returns a 16b unsigned value which is 256*16*log2((img^2 + real^2)^0.5).
+  // the high byte is the table value of fht_mag_log(), the low byte goes
+  // linearly from there to the next table entry
+  asm volatile (
+  "ldi r26, lo8(fht_input) \n" // set to beginning of data space
+  "ldi r27, hi8(fht_input) \n"
+  "ldi r28, lo8(fht_log_out16) \n" // set to beginning of result space
+  "ldi r29, hi8(fht_log_out16) \n"
+  "ldi r30, lo8(fht_input + " STRINGIFY(FHT_N*2) ") \n" // set to end of data space
+  "ldi r31, hi8(fht_input + " STRINGIFY(FHT_N*2) ") \n"
+  "movw r8,r30 \n" // z register clobbered below
+  "clr r15 \n" // clear null register
+  "ldi r20, " STRINGIFY(FHT_N/2) " \n" // set loop counter
+  "ld r16,x+ \n" // do zero frequency bin first
+  "ld r17,x+ \n"
+  "movw r18,r16 \n" // double zero frequency bin
+  "rjmp 10f \n" // skip ahead
+
+  "1: \n"
+  "movw r30,r8 \n" // restore z register
+  "ld r16,x+ \n" // fetch real
+  "ld r17,x+ \n"
+  "ld r19,-Z \n" // fetch imaginary
+  "ld r18,-Z \n"
+  "movw r8,r30 \n" // store z register
+
+  // process real^2
+  "10: \n"
+  "muls r17,r17 \n"
+  "movw r4,r0 \n"
+  "mul r16,r16 \n"
+  "movw r2,r0 \n"
+  "fmulsu r17,r16 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // process img^2 and accumulate
+  "muls r19,r19 \n"
+  "movw r6,r0 \n"
+  "mul r18,r18 \n"
+  "add r2,r0 \n"
+  "adc r3,r1 \n"
+  "adc r4,r6 \n"
+  "adc r5,r7 \n"
+  "fmulsu r19,r18 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // decibel of the square root via lookup table, as fht_mag_log(). the top
+  // non zero byte is scaled to 0x40 or more, the byte below it (r4, r3 or
+  // r2) is the fraction and r17 is 16 times the exponent
+  "tst r5 \n"
+  "breq 3f \n"
+  "ldi r17,0xc0 \n"
+  "mov r30,r5 \n"
+
+  // normalize 0, 2, 4 or 6 bits
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "cpi r30,0x10 \n"
+  "brsh 2f \n"
+  "swap r30 \n" // top nibble is empty, so this is r30 << 4
+  "swap r4 \n"
+  "mov r16,r4 \n"
+  "andi r16,0x0f \n"
+  "or r30,r16 \n"
+  "eor r4,r16 \n"
+  "subi r17,0x20 \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "2: \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+
+  "8: \n"
+  "ldi r31, hi8(_log_table16) \n"
+  "lpm r16,z \n" // fetch log compressed square root, times 2
+  "lsr r16 \n" // carry set if the next entry is one higher
+  "brcs 11f \n"
+  "st y+,r15 \n" // else there is nothing to interpolate
+  "add r16,r17 \n" // add exponent
+  "st y+,r16 \n" // store value
+  "dec r20 \n" // check if all data processed
+  "brne 1b \n"
+  "rjmp 9f \n"
+  "3: \n"
+  "tst r4 \n"
+  "breq 5f \n"
+  "ldi r17,0x80 \n"
+  "mov r30,r4 \n"
+
+  "cpi r30,0x40 \n"
+  "brsh 8b \n"
+  "cpi r30,0x10 \n"
+  "brsh 4f \n"
+  "swap r30 \n"
+  "swap r3 \n"
+  "mov r16,r3 \n"
+  "andi r16,0x0f \n"
+  "or r30,r16 \n"
+  "eor r3,r16 \n"
+  "subi r17,0x20 \n"
+  "cpi r30,0x40 \n"
+  "brsh 8b \n"
+  "4: \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+  "rjmp 8b \n"
+
+  "5: \n"
+  "tst r3 \n"
+  "breq 7f \n"
+  "ldi r17,0x40 \n"
+  "mov r30,r3 \n"
+
+  "cpi r30,0x40 \n"
+  "brsh 8b \n"
+  "cpi r30,0x10 \n"
+  "brsh 6f \n"
+  "swap r30 \n"
+  "swap r2 \n"
+  "mov r16,r2 \n"
+  "andi r16,0x0f \n"
+  "or r30,r16 \n"
+  "eor r2,r16 \n"
+  "subi r17,0x20 \n"
+  "cpi r30,0x40 \n"
+  "brsh 8b \n"
+  "6: \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+  "rjmp 8b \n"
+
+  // below 256 the table has every value, there is no fraction
+  "7: \n"
+  "mov r30,r2 \n"
+  "ldi r31, hi8(_log_table16) \n"
+  "lpm r16,z \n"
+  "lsr r16 \n"
+  "st y+,r15 \n" // store value
+  "st y+,r16 \n"
+  "dec r20 \n" // check if all data processed
+  "breq 9f \n"
+  "rjmp 1b \n"
+
+  "11: \n" // store the fraction, the exponent tells which byte it is
+  "cpi r17,0x50 \n"
+  "brlo 13f \n"
+  "cpi r17,0x90 \n"
+  "brlo 12f \n"
+  "st y+,r4 \n"
+  "add r16,r17 \n"
+  "st y+,r16 \n"
+  "dec r20 \n"
+  "breq 9f \n"
+  "rjmp 1b \n"
+  "12: \n"
+  "st y+,r3 \n"
+  "add r16,r17 \n"
+  "st y+,r16 \n"
+  "dec r20 \n"
+  "breq 9f \n"
+  "rjmp 1b \n"
+  "13: \n"
+  "st y+,r2 \n"
+  "add r16,r17 \n"
+  "st y+,r16 \n"
+  "dec r20 \n"
+  "breq 9f \n"
+  "rjmp 1b \n"
+  "9: \n" // all done
+  : :
+  : "r0", "r26", "r27", "r30", "r31", "r18", "r19", "r20" // clobber list
+  );
+
+  // get the clobbers off the stack
+  asm volatile (
+  "pop r29 \n"
+  "pop r28 \n"
+  "pop r17 \n"
+  "pop r16 \n"
+  "pop r15 \n"
+  "pop r9 \n"
+  "pop r8 \n"
+  "pop r7 \n"
+  "pop r6 \n"
+  "pop r5 \n"
+  "pop r4 \n"
+  "pop r3 \n"
+  "pop r2 \n"
+  "clr r1 \n" // reset c compiler null register
+  );
+}
+#endif
+
+#if ((LOG_BANDS > 0)&&(LOG_OUT16 == 1))
+// 256*16*log2((img^2 + real^2)^0.5) of one bin, the same math as
+// fht_mag_log16(). the compiler saves whatever it needs of the clobbered
+// registers once per calling function, not once per bin
+static inline uint16_t fht_log_bin16(int16_t real, int16_t img) {
+  uint16_t out;
+  asm volatile (
+  "movw r16,%A1 \n" // fetch real
+  "movw r18,%A2 \n" // fetch imaginary
+  "clr r15 \n" // clear null register
+
+  // process real^2
+  "muls r17,r17 \n"
+  "movw r4,r0 \n"
+  "mul r16,r16 \n"
+  "movw r2,r0 \n"
+  "fmulsu r17,r16 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // process img^2 and accumulate
+  "muls r19,r19 \n"
+  "movw r6,r0 \n"
+  "mul r18,r18 \n"
+  "add r2,r0 \n"
+  "adc r3,r1 \n"
+  "adc r4,r6 \n"
+  "adc r5,r7 \n"
+  "fmulsu r19,r18 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // decibel of the square root via lookup table, as fht_mag_log16(). the
+  // blocks are in the order that lets each path fall through to the end
+  "tst r5 \n"
+  "brne 2f \n"
+  "tst r4 \n"
+  "breq 5f \n"
+  "ldi r17,0x80 \n"
+  "mov r30,r4 \n"
+
+  "4: \n" // normalize 2 bits at a time, as fht_log_bin()
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+  "rjmp 4b \n"
+
+  "5: \n"
+  "tst r3 \n"
+  "breq 7f \n"
+  "ldi r17,0x40 \n"
+  "mov r30,r3 \n"
+
+  "6: \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+  "rjmp 6b \n"
+
+  // below 256 the table has every value, there is no fraction
+  "7: \n"
+  "mov r30,r2 \n"
+  "ldi r31, hi8(_log_table16) \n"
+  "lpm r16,z \n"
+  "lsr r16 \n"
+  "clr %A0 \n"
+  "mov %B0,r16 \n"
+  "rjmp 9f \n"
+
+  "11: \n" // store the fraction, the exponent tells which byte it is
+  "mov %A0,r4 \n"
+  "cpi r17,0x90 \n"
+  "brsh 12f \n"
+  "mov %A0,r3 \n"
+  "cpi r17,0x50 \n"
+  "brsh 12f \n"
+  "mov %A0,r2 \n"
+  "rjmp 12f \n"
+
+  "2: \n"
+  "ldi r17,0xc0 \n"
+  "mov r30,r5 \n"
+
+  // normalize 0, 2, 4 or 6 bits
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "cpi r30,0x10 \n"
+  "brsh 3f \n"
+  "swap r30 \n"
+  "swap r4 \n"
+  "mov r16,r4 \n"
+  "andi r16,0x0f \n"
+  "or r30,r16 \n"
+  "eor r4,r16 \n"
+  "subi r17,0x20 \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "3: \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "subi r17,0x10 \n"
+
+  "8: \n"
+  "ldi r31, hi8(_log_table16) \n"
+  "lpm r16,z \n" // fetch log compressed square root, times 2
+  "lsr r16 \n" // carry set if the next entry is one higher
+  "brcs 11b \n"
+  "clr %A0 \n" // else there is nothing to interpolate
+  "12: \n"
+  "add r16,r17 \n" // add exponent
+  "mov %B0,r16 \n"
+
+  "9: \n"
+  "clr r1 \n" // reset c compiler null register
+  : "=r" (out)
+  : "r" (real), "r" (img)
+  : "r0", "r2", "r3", "r4", "r5", "r6", "r7", "r15", "r16", "r17", "r18", "r19", "r30", "r31" // clobber list
+  );
+  return out;
+}
+#elif (LOG_BANDS > 0)
+// 16*log2((img^2 + real^2)^0.5) of one bin, the same math as fht_mag_log().
+// the compiler saves whatever it needs of the clobbered registers once per
+// calling function, not once per bin
+static inline uint8_t fht_log_bin(int16_t real, int16_t img) {
+  uint8_t out;
+  asm volatile (
+  "movw r16,%A1 \n" // fetch real
+  "movw r18,%A2 \n" // fetch imaginary
+  "clr r15 \n" // clear null register
+
+  // process real^2
+  "muls r17,r17 \n"
+  "movw r4,r0 \n"
+  "mul r16,r16 \n"
+  "movw r2,r0 \n"
+  "fmulsu r17,r16 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // process img^2 and accumulate
+  "muls r19,r19 \n"
+  "movw r6,r0 \n"
+  "mul r18,r18 \n"
+  "add r2,r0 \n"
+  "adc r3,r1 \n"
+  "adc r4,r6 \n"
+  "adc r5,r7 \n"
+  "fmulsu r19,r18 \n" // automatically does x2
+  "sbc r5,r15 \n"
+  "add r3,r0 \n"
+  "adc r4,r1 \n"
+  "adc r5,r15 \n"
+
+  // decibel of the square root via lookup table
+  // scales the magnitude to an 8b value times an 8b exponent
+  "clr r17 \n" // clear exponent register
+  "tst r5 \n"
+  "breq 3f \n"
+  "ldi r17,0x0c \n"
+  "mov r30,r5 \n"
+
+  "2: \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "lsl r4 \n"
+  "rol r30 \n"
+  "dec r17 \n"
+  "rjmp 2b \n"
+
+  "3: \n"
+  "tst r4 \n"
+  "breq 5f \n"
+  "ldi r17,0x08 \n"
+  "mov r30,r4 \n"
+
+  "4: \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "lsl r3 \n"
+  "rol r30 \n"
+  "dec r17 \n"
+  "rjmp 4b \n"
+
+  "5: \n"
+  "tst r3 \n"
+  "breq 7f \n"
+  "ldi r17,0x04 \n"
+  "mov r30,r3 \n"
+
+  "6: \n"
+  "cpi r30,0x40 \n"
+  "brsh 8f \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "lsl r2 \n"
+  "rol r30 \n"
+  "dec r17 \n"
+  "rjmp 6b \n"
+
+  "7: \n"
+  "mov r30,r2 \n"
+
+  "8: \n"
+  "clr r31 \n"
+  "subi r30, lo8(-(_log_table)) \n" // add offset to lookup table pointer
+  "sbci r31, hi8(-(_log_table)) \n"
+  "lpm r16,z \n" // fetch log compressed square root
+  "swap r17 \n"  // multiply exponent by 16
+  "add r16,r17 \n" // add for final value
+  "mov %0,r16 \n"
+  "clr r1 \n" // reset c compiler null register
+  : "=r" (out)
+  : "r" (real), "r" (img)
+  : "r0", "r2", "r3", "r4", "r5", "r6", "r7", "r15", "r16", "r17", "r18", "r19", "r30", "r31" // clobber list
+  );
+  return out;
+}
+#endif
+
+#if (LOG_BANDS > 0)
+// fht_mag_log() with the usual post processing done in the same pass, so
+// the spectrum is only walked once. for each bin i of the N/2:
+// out[i] - log magnitude as fht_mag_log(), 0 if below fht_gate. with LOG_OUT16
+//          set it is the 16b value of fht_mag_log16(), and so are fht_gate,
+//          fht_decay, peak[] and fht_band_max[]
+// peak[i] - peak hold, follows rises at once and falls by fht_decay per call
+// for each band b of fht_bands[]:
+// fht_band_max[b] - largest out[i] of the band
+// fht_band_flux[b] - sum of out[i] rises since the last call (spectral flux),
+//                    out[] must still hold the previous spectrum for this
+static inline void fht_mag_log_bands(fht_log_t *out, fht_log_t *peak) {
+  uint8_t band = 0;
+  uint8_t band_end = fht_bands[0]; // bins before the first band are not counted
+  fht_log_t this_max = 0;
+  fht_flux_t this_flux = 0;
+  int *img = fht_input + FHT_N;
+  for (uint8_t i = 0; i < (FHT_N/2); i++) {
+#if (LOG_OUT16 == 1)
+    fht_log_t value = fht_log_bin16(fht_input[i], i ? *--img : fht_input[0]); // double zero frequency bin
+#else
+    fht_log_t value = fht_log_bin(fht_input[i], i ? *--img : fht_input[0]);
+#endif
+    if (value < fht_gate) value = 0;
+    if (i == band_end) { // band boundary, store the finished band
+      if (i > fht_bands[0]) {
+        fht_band_max[band] = this_max;
+        fht_band_flux[band] = this_flux;
+        band++;
+      }
+      this_max = 0;
+      this_flux = 0;
+      band_end = (band < (LOG_BANDS)) ? fht_bands[band + 1] : 0xff;
+    }
+    if (value > this_max) this_max = value;
+    if (value > out[i]) this_flux += value - out[i];
+    out[i] = value;
+    fht_log_t this_peak = peak[i];
+    if (value > this_peak) this_peak = value;
+    peak[i] = (this_peak > fht_decay) ? this_peak - fht_decay : 0;
+  }
+  if (band < (LOG_BANDS)) { // last band ends with the spectrum
+    fht_band_max[band] = this_max;
+    fht_band_flux[band] = this_flux;
+  }
+}
+#endif
+
 static inline void fht_mag_lin(void) {
   // save registers that are getting clobbered
   // avr-gcc requires r2:r17,r28:r29, and r1 cleared
@@ -1257,6 +1868,29 @@ static inline void fht_window(void) {
 }
 
 
+// bit reversed index of an fht_input[] slot, this is where fht_reorder() would
+// move a sample placed at index i
+static inline uint8_t fht_bitrev(uint8_t i) {
+  uint8_t r = 0;
+  for (uint8_t b = 0; b < LOG_N; b++) {
+    r = (r << 1) | (i & 0x01);
+    i >>= 1;
+  }
+  return r;
+}
+
+// capture time input: windows sample number i (if WINDOW == 1) and stores it
+// straight to its reordered slot. filling all FHT_N samples this way replaces
+// fht_window() and fht_reorder(), so fht_run() can be called right after the
+// last sample. the window multiply is the same 16b x 16b >> 15 as fht_window()
+static inline void fht_input_put(uint8_t i, int16_t sample) {
+#if (WINDOW == 1)
+  sample = ((int32_t)sample * (int16_t)pgm_read_word(&_window_func[i])) >> 15;
+#endif
+  fht_input[fht_bitrev(i)] = sample;
+}
+
+
 static inline void fht_mag_octave(void) {
   // save registers that are getting clobbered
   // avr-gcc only requires r2:r17,r28:r29, and r1 cleared
@@ -0,0 +1,80 @@
+/*
+fht_log16_bench.pde
+example sketch for comparing fht_mag_log16() with fht_mag_log().
+it runs the fht on a synthetic tone plus noise at several levels, from
+very quiet to full scale, and times both log functions on the same
+spectrum.  the results are sent out over the serial port at 115.2kb:
+  log / log16 - time for one call (us)
+  diff - largest difference of the log16 high byte from fht_mag_log()
+  steps - how many different values the bins come out as, 8b / 16b.
+          on quiet signals the 8b output only has a few of them
+no adc or audio source is needed.
+*/
+
+#define LOG_OUT 1 // use the log output function
+#define LOG_OUT16 1 // use the 16b log output function
+#define FHT_N 64 // set to 64 point fht
+#define WINDOW 0 // no window, the tone is right on a bin
+
+#include <FHT.h> // include the library
+
+#define TONE_BIN 8 // tone frequency in bins
+#define RUNS 100 // calls timed per function
+
+const int levels[] = {4, 16, 64, 256, 1024, 8192, 24000}; // tone amplitude, noise is +-1/4 of it
+
+// counts the different values of the output
+uint8_t countSteps(uint16_t *v) {
+  uint8_t steps = 0;
+  for (uint8_t i = 0 ; i < FHT_N / 2 ; i++) {
+    uint8_t j = 0;
+    while (j < i && v[j] != v[i]) j++;
+    if (j == i) steps++;
+  }
+  return steps;
+}
+
+void setup() {
+  Serial.begin(115200); // use the serial port
+  randomSeed(1);
+  for (byte l = 0 ; l < sizeof(levels) / sizeof(int) ; l++) {
+    for (int i = 0 ; i < FHT_N ; i++) {
+      fht_input[i] = levels[l] * sin(2 * PI * TONE_BIN * i / FHT_N) +
+                     random(-levels[l] / 4, levels[l] / 4 + 1);
+    }
+    fht_reorder(); // reorder the data before doing the fht
+    fht_run(); // process the data in the fht
+
+    // the log functions only read fht_input[], so they can run again and again
+    unsigned long start = micros();
+    for (byte r = 0 ; r < RUNS ; r++) fht_mag_log();
+    unsigned long t8 = micros() - start;
+    start = micros();
+    for (byte r = 0 ; r < RUNS ; r++) fht_mag_log16();
+    unsigned long t16 = micros() - start;
+
+    uint8_t diff = 0;
+    uint16_t v8[FHT_N / 2];
+    for (uint8_t i = 0 ; i < FHT_N / 2 ; i++) {
+      uint8_t d = abs((int)(fht_log_out16[i] >> 8) - fht_log_out[i]);
+      if (d > diff) diff = d;
+      v8[i] = fht_log_out[i];
+    }
+
+    Serial.print("level ");
+    Serial.print(levels[l]);
+    Serial.print("  log ");
+    Serial.print((float)t8 / RUNS);
+    Serial.print(" us  log16 ");
+    Serial.print((float)t16 / RUNS);
+    Serial.print(" us  diff ");
+    Serial.print(diff);
+    Serial.print("  steps ");
+    Serial.print(countSteps(v8));
+    Serial.print(" / ");
+    Serial.println(countSteps(fht_log_out16));
+  }
+}
+
+void loop() {
+}
@@ -0,0 +1,77 @@
+/*
+fht_window_bench.pde
+example sketch for comparing the window functions (WINDOW_FUNC).
+it runs the fht on a synthetic tone for each window, once with the
+tone right on a bin and once halfway between two bins, and sends
+the results out over the serial port at 115.2kb:
+  peak  - magnitude of the loudest bin
+  scallop - how much lower the peak gets between bins (dB)
+  leak4 / leak6 - loudest bin 4 / 6 or more bins away from the tone (dB)
+the windows are worked out at runtime with the same constexpr functions
+FHT.h uses to build its table, so no adc or audio source is needed.
+*/
+
+#define LIN_OUT 1 // use the linear output function
+#define FHT_N 64 // set to 64 point fht
+#define WINDOW 0 // windowing is done here, not by fht_window()
+
+#include <FHT.h> // include the library
+
+#define TONE_BIN 8 // tone frequency in bins
+
+const char *names[] = {"hann", "blackman-harris", "flat-top"};
+int16_t window[FHT_N];
+
+// runs the fht on a windowed tone at bin k, returns loudest bin and leakage
+uint16_t measure(float k, float *leak4, float *leak6) {
+  for (int i = 0 ; i < FHT_N ; i++) {
+    int16_t x = 0.9 * 32767 * sin(2 * PI * k * i / FHT_N);
+    fht_input[i] = ((int32_t)x * window[i]) >> 15;
+  }
+  fht_reorder(); // reorder the data before doing the fht
+  fht_run(); // process the data in the fht
+  fht_mag_lin(); // take the output of the fht
+  uint16_t peak = 0;
+  uint16_t far4 = 1, far6 = 1;
+  for (int i = 1 ; i < FHT_N / 2 ; i++) { // skip dc
+    uint16_t m = fht_lin_out[i];
+    if (m > peak) peak = m;
+    if (abs(i - k) >= 4 && m > far4) far4 = m;
+    if (abs(i - k) >= 6 && m > far6) far6 = m;
+  }
+  *leak4 = 20 * log10((float)far4 / peak);
+  *leak6 = 20 * log10((float)far6 / peak);
+  return peak;
+}
+
+void setup() {
+  Serial.begin(115200); // use the serial port
+  for (byte f = 0 ; f < 3 ; f++) {
+    for (int i = 0 ; i < FHT_N ; i++) {
+      window[i] = fht_window_q15(fht_window_shape(f, i, FHT_N));
+    }
+    float on4, on6, off4, off6;
+    uint16_t on = measure(TONE_BIN, &on4, &on6);
+    uint16_t off = measure(TONE_BIN + 0.5, &off4, &off6);
+    Serial.print(f);
+    Serial.print(" ");
+    Serial.println(names[f]);
+    Serial.print("  peak ");
+    Serial.print(on);
+    Serial.print("  scallop ");
+    Serial.print(20 * log10((float)off / on));
+    Serial.println(" dB");
+    Serial.print("  leak4 ");
+    Serial.print(on4);
+    Serial.print(" / ");
+    Serial.print(off4);
+    Serial.print(" dB  leak6 ");
+    Serial.print(on6);
+    Serial.print(" / ");
+    Serial.print(off6);
+    Serial.println(" dB (on bin / between bins)");
+  }
+}
+
+void loop() {
+}
@@ -2,6 +2,7 @@
 #define __PROG_TYPES_COMPAT__
 
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 #include "FastLED.h"
@@ -9,6 +10,98 @@
 FASTLED_NAMESPACE_BEGIN
 
 
+// Array kernels for 32-bit targets.
+//
+// On AVR the per-byte lib8tion primitives are already hand-tuned assembly,
+// but elsewhere nscale8, fadeToBlackBy, nblend and blur1d walk the pixel
+// array one byte at a time.  With COLORUTILS_SWAR these work on four bytes
+// per 32-bit word instead (SIMD-within-a-register): the bytes are split
+// into two 16-bit lanes per half, multiplied, and recombined.  Results are
+// bit-for-bit the same as scale8, blend8 and qadd8.  Where the ARM DSP
+// instructions are available the saturating add is a single uqadd8.
+#ifndef COLORUTILS_SWAR
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define COLORUTILS_SWAR 1
+#else
+#define COLORUTILS_SWAR 0
+#endif
+#endif
+
+#if COLORUTILS_SWAR == 1
+#define SWAR_LO 0x00FF00FFUL
+
+static inline uint32_t swar_load( const uint8_t* p)
+{
+    uint32_t w;
+    memcpy( &w, p, 4);
+    return w;
+}
+
+static inline void swar_store( uint8_t* p, uint32_t w)
+{
+    memcpy( p, &w, 4);
+}
+
+// scale8 of four bytes; 'mul' is the scale, plus one with FASTLED_SCALE8_FIXED
+static inline uint32_t swar_scale8( uint32_t w, uint16_t mul)
+{
+    uint32_t even = (((w & SWAR_LO) * mul) >> 8) & SWAR_LO;
+    uint32_t odd  = (((w >> 8) & SWAR_LO) * mul) & ~SWAR_LO;
+    return even | odd;
+}
+
+static inline uint16_t swar_scale_mul( fract8 scale)
+{
+#if (FASTLED_SCALE8_FIXED == 1)
+    return (uint16_t)scale + 1;
+#else
+    return scale;
+#endif
+}
+
+// qadd8 of four bytes
+static inline uint32_t swar_qadd8( uint32_t a, uint32_t b)
+{
+#if QADD8_ARM_DSP_ASM == 1
+    asm volatile( "uqadd8 %0, %0, %1" : "+r" (a) : "r" (b));
+    return a;
+#else
+    uint32_t sum = (a & 0x7F7F7F7FUL) + (b & 0x7F7F7F7FUL);
+    uint32_t carry = ((a & b) | ((a | b) & sum)) & 0x80808080UL;
+    sum ^= (a ^ b) & 0x80808080UL;
+    return sum | ((carry >> 7) * 0xFF);
+#endif
+}
+
+#if (FASTLED_BLEND_FIXED == 1)
+// blend8 of four bytes: (a * (255-t) + a + b * t + b) >> 8, which never
+// exceeds 16 bits per lane, so the lanes cannot carry into each other
+static inline uint32_t swar_blend8( uint32_t a, uint32_t b, uint16_t mula, uint16_t mulb)
+{
+    uint32_t even = (((a & SWAR_LO) * mula + (b & SWAR_LO) * mulb) >> 8) & SWAR_LO;
+    uint32_t odd  = (((a >> 8) & SWAR_LO) * mula + ((b >> 8) & SWAR_LO) * mulb) & ~SWAR_LO;
+    return even | odd;
+}
+#endif
+
+static void swar_nscale8( uint8_t* p, uint32_t count, uint16_t mul)
+{
+    // bring p to a word boundary, then whole words, then the rest
+    while( count && ((uintptr_t)p & 3)) {
+        *p = ((uint16_t)*p * mul) >> 8;
+        p++; count--;
+    }
+    for( ; count >= 4; count -= 4, p += 4) {
+        swar_store( p, swar_scale8( swar_load( p), mul));
+    }
+    while( count--) {
+        *p = ((uint16_t)*p * mul) >> 8;
+        p++;
+    }
+}
+#endif
+
+
 
 void fill_solid( struct CRGB * leds, int numToFill,
                  const struct CRGB& color)
@@ -204,9 +297,13 @@ void nscale8_raw( CRGB* leds, uint16_t num_leds, uint8_t scale)
 
 void nscale8( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if COLORUTILS_SWAR == 1
+    swar_nscale8( (uint8_t*)leds, (uint32_t)num_leds * 3, swar_scale_mul( scale));
+#else
     for( uint16_t i = 0; i < num_leds; i++) {
         leds[i].nscale8( scale);
     }
+#endif
 }
 
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
@@ -261,11 +358,33 @@ CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay )
 
 void nblend( CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOverlay)
 {
+#if (COLORUTILS_SWAR == 1) && (FASTLED_BLEND_FIXED == 1)
+    if( amountOfOverlay == 0) {
+        return;
+    }
+    if( amountOfOverlay == 255) {
+        memmove( existing, overlay, count * sizeof(CRGB));
+        return;
+    }
+    uint8_t* dst = (uint8_t*)existing;
+    const uint8_t* src = (const uint8_t*)overlay;
+    uint32_t bytes = (uint32_t)count * 3;
+    uint16_t mula = 256 - amountOfOverlay;
+    uint16_t mulb = (uint16_t)amountOfOverlay + 1;
+    for( ; bytes >= 4; bytes -= 4, dst += 4, src += 4) {
+        swar_store( dst, swar_blend8( swar_load( dst), swar_load( src), mula, mulb));
+    }
+    while( bytes--) {
+        *dst = blend8( *dst, *src, amountOfOverlay);
+        dst++; src++;
+    }
+#else
     for( uint16_t i = count; i; i--) {
         nblend( *existing, *overlay, amountOfOverlay);
         existing++;
         overlay++;
     }
+#endif
 }
 
 CRGB blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 )
@@ -384,6 +503,39 @@ void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
 {
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
+#if COLORUTILS_SWAR == 1
+    // Every channel byte becomes keep * itself + seep * the same channel
+    // of both neighbors (3 bytes away), all saturating, which is what the
+    // carryover loop below computes.  'prev' keeps the original bytes of
+    // the word that has already been overwritten.
+    uint8_t* p = (uint8_t*)leds;
+    uint32_t bytes = (uint32_t)numLeds * 3;
+    uint16_t mulk = swar_scale_mul( keep);
+    uint16_t muls = swar_scale_mul( seep);
+    uint32_t prev = 0;
+    uint32_t j = 0;
+    if( bytes >= 8) {
+        uint32_t cur = swar_load( p);
+        for( ; j + 8 <= bytes; j += 4) {
+            uint32_t next = swar_load( p + j + 4);
+            uint32_t left = (prev >> 8) | (cur << 24);
+            uint32_t right = (cur >> 24) | (next << 8);
+            uint32_t out = swar_qadd8( swar_scale8( cur, mulk), swar_scale8( left, muls));
+            swar_store( p + j, swar_qadd8( out, swar_scale8( right, muls)));
+            prev = cur;
+            cur = next;
+        }
+    }
+    // the last 0..7 bytes: o[k] holds the original byte j - 4 + k,
+    // zero past both ends of the strip
+    uint8_t o[16] = { 0 };
+    swar_store( o, prev);
+    memcpy( o + 4, p + j, bytes - j);
+    for( uint8_t k = 4; j < bytes; j++, k++) {
+        uint8_t out = qadd8( scale8( o[k], keep), scale8( o[k - 3], seep));
+        p[j] = qadd8( out, scale8( o[k + 3], seep));
+    }
+#else
     CRGB carryover = CRGB::Black;
     for( uint16_t i = 0; i < numLeds; i++) {
         CRGB cur = leds[i];
@@ -395,6 +547,7 @@ void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
         leds[i] = cur;
         carryover = part;
     }
+#endif
 }
 
 void blur2d( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
@@ -1096,6 +1249,46 @@ void UpscalePalette(const struct CHSVPalette32& srcpal32, struct CHSVPalette256&
 }
 
 
+bool CRGBPaletteCache::changed( const CRGB* entries, uint8_t size, uint8_t brightness, TBlendType blendType)
+{
+    if( size == mSize && brightness == mBrightness && blendType == mBlendType
+        && memcmp( mSource, entries, size * sizeof(CRGB)) == 0) {
+        return false;
+    }
+    memmove8( mSource, entries, size * sizeof(CRGB));
+    mSize = size;
+    mBrightness = brightness;
+    mBlendType = blendType;
+    return true;
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette16& pal, uint8_t brightness, TBlendType blendType)
+{
+    if( !changed( pal.entries, 16, brightness, blendType)) return false;
+    if( brightness == 255 && blendType == LINEARBLEND) {
+        UpscalePalette( pal, mExpanded);
+    } else {
+        for( int i = 0; i < 256; i++) {
+            mExpanded[(uint8_t)(i)] = ColorFromPalette( pal, i, brightness, blendType);
+        }
+    }
+    return true;
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette32& pal, uint8_t brightness, TBlendType blendType)
+{
+    if( !changed( pal.entries, 32, brightness, blendType)) return false;
+    if( brightness == 255 && blendType == LINEARBLEND) {
+        UpscalePalette( pal, mExpanded);
+    } else {
+        for( int i = 0; i < 256; i++) {
+            mExpanded[(uint8_t)(i)] = ColorFromPalette( pal, i, brightness, blendType);
+        }
+    }
+    return true;
+}
+
+
 
 #if 0
 // replaced by PartyColors_p
@@ -1551,6 +1551,53 @@ CHSV ColorFromPalette( const CHSVPalette32& pal,
                       TBlendType blendType=LINEARBLEND);
 
 
+// CRGBPaletteCache - a 16- or 32-entry palette expanded into 256 entries
+// once, with an optional brightness and blend type baked in.
+//
+// Call update() with the source palette before using the cache (e.g. once
+// per frame); it re-expands only if the palette, brightness, or blend type
+// differ from the last call, so it is cheap when nothing has changed.
+// After that, cache[index] gives the same color as
+// ColorFromPalette( pal, index, brightness, blendType) with a single load.
+//
+// Costs 768 bytes of RAM for the expanded entries plus 100 for the copy
+// of the source used to detect changes.
+class CRGBPaletteCache {
+public:
+    CRGBPaletteCache() : mSize(0), mBrightness(255), mBlendType(LINEARBLEND) {}
+
+    // returns true if the palette had to be expanded again
+    bool update( const CRGBPalette16& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+    bool update( const CRGBPalette32& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+    bool update( const TProgmemRGBPalette16& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
+    {
+        return update( CRGBPalette16( pal), brightness, blendType);
+    }
+    bool update( const TProgmemRGBPalette32& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
+    {
+        return update( CRGBPalette32( pal), brightness, blendType);
+    }
+
+    // forget the cached palette; the next update() expands again
+    void invalidate() { mSize = 0; }
+
+    inline const CRGB& operator[] (uint8_t index) const __attribute__((always_inline))
+    {
+        return mExpanded.entries[index];
+    }
+    const CRGBPalette256& palette() const { return mExpanded; }
+
+private:
+    bool changed( const CRGB* entries, uint8_t size, uint8_t brightness, TBlendType blendType);
+
+    CRGBPalette256 mExpanded;
+    CRGB mSource[32];
+    uint8_t mSize;
+    uint8_t mBrightness;
+    TBlendType mBlendType;
+};
+
+
 // Fill a range of LEDs with a sequece of entryies from a palette
 template <typename PALETTE>
 void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
@@ -40,6 +40,8 @@ class CLEDController {
 protected:
     friend class CFastLED;
     CRGB *m_Data;
+    uint8_t *m_Index;
+    const CRGB *m_Palette;
     CLEDController *m_pNext;
     CRGB m_ColorCorrection;
     CRGB m_ColorTemperature;
@@ -60,9 +62,17 @@ protected:
 	///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale) = 0;
 
+	/// write indexed color data out to the leds managed by this controller.  Controllers that don't
+	/// support indexed data don't write anything out.
+	///@param index one byte per led, the index of its color in the palette
+	///@param palette the colors the index bytes refer to
+	///@param nLeds the number of leds being written out
+	///@param scale the rgb scaling to apply to each led before writing it out
+    virtual void showIndexed(const uint8_t *index, const CRGB *palette, int nLeds, CRGB scale) { }
+
 public:
 	/// create an led controller object, add it to the chain of controllers
-    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
+    CLEDController() : m_Data(NULL), m_Index(NULL), m_Palette(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
         m_pNext = NULL;
         if(m_pHead==NULL) { m_pHead = this; }
         if(m_pTail != NULL) { m_pTail->m_pNext = this; }
@@ -87,7 +97,11 @@ public:
 
     /// show function using the "attached to this controller" led data
     void showLeds(uint8_t brightness=255) {
-        show(m_Data, m_nLeds, getAdjustment(brightness));
+        if(m_Palette) {
+            showIndexed(m_Index, m_Palette, m_nLeds, getAdjustment(brightness));
+        } else {
+            show(m_Data, m_nLeds, getAdjustment(brightness));
+        }
     }
 
 	/// show the given color on the led strip
@@ -103,15 +117,38 @@ public:
 	/// set the default array of leds to be used by this controller
     CLEDController & setLeds(CRGB *data, int nLeds) {
         m_Data = data;
+        m_Index = NULL;
+        m_Palette = NULL;
         m_nLeds = nLeds;
         return *this;
     }
 
+	/// set an indexed color array of leds to be used by this controller instead of a CRGB array.  Each led
+	/// is one byte, an index into the palette, and is turned into rgb as it is written out - 1 byte of ram
+	/// per led instead of 3.  The palette can be changed between frames, up to 256 entries.
+	/// On AVR this needs #define FASTLED_AVR_INDEXED 1 before including FastLED.h, so the clockless chipsets
+	/// get their indexed output loop.  Without it a call to setLedsIndexed is a compile error.
+#if defined(FASTLED_AVR) && (FASTLED_AVR_INDEXED == 0)
+    CLEDController & setLedsIndexed(uint8_t *index, const CRGB *palette, int nLeds)
+        __attribute__((error("setLedsIndexed on AVR needs #define FASTLED_AVR_INDEXED 1 before #include <FastLED.h>")));
+#else
+    CLEDController & setLedsIndexed(uint8_t *index, const CRGB *palette, int nLeds) {
+        m_Data = NULL;
+        m_Index = index;
+        m_Palette = palette;
+        m_nLeds = nLeds;
+        return *this;
+    }
+#endif
+
 	/// zero out the led data managed by this controller
     void clearLedData() {
         if(m_Data) {
             memset8((void*)m_Data, 0, sizeof(struct CRGB) * m_nLeds);
         }
+        if(m_Index) {
+            memset8((void*)m_Index, 0, m_nLeds);
+        }
     }
 
     /// How many leds does this controller manage?
@@ -120,6 +157,12 @@ public:
     /// Pointer to the CRGB array for this controller
     CRGB* leds() { return m_Data; }
 
+    /// Pointer to the index array for this controller, if it was set up with setLedsIndexed
+    uint8_t* ledIndex() { return m_Index; }
+
+    /// Pointer to the palette for the index array
+    const CRGB* palette() { return m_Palette; }
+
     /// Reference to the n'th item in the controller
     CRGB &operator[](int x) { return m_Data[x]; }
 
@@ -177,6 +220,8 @@ public:
 template<EOrder RGB_ORDER, int LANES=1, uint32_t MASK=0xFFFFFFFF>
 struct PixelController {
         const uint8_t *mData;
+        const CRGB *mPalette;
+        const uint8_t *mIndex;
         int mLen,mLenRemaining;
         uint8_t d[3];
         uint8_t e[3];
@@ -192,6 +237,8 @@ struct PixelController {
             e[1] = other.e[1];
             e[2] = other.e[2];
             mData = other.mData;
+            mPalette = other.mPalette;
+            mIndex = other.mIndex;
             mScale = other.mScale;
             mAdvance = other.mAdvance;
             mLenRemaining = mLen = other.mLen;
@@ -207,20 +254,29 @@ struct PixelController {
           }
         }
 
-        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), mPalette(NULL), mIndex(NULL), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mData += skip;
             mAdvance = (advance) ? 3+skip : 0;
             initOffsets(len);
         }
 
-        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), mPalette(NULL), mIndex(NULL), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mAdvance = 3;
             initOffsets(len);
         }
 
-        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), mPalette(NULL), mIndex(NULL), mLen(len), mLenRemaining(len), mScale(s) {
+            enable_dithering(dither);
+            mAdvance = 0;
+            initOffsets(len);
+        }
+
+        // Indexed color data - mData points at the palette entry of the current led, advanceData looks up the
+        // next one, so the load/scale functions below read it like plain rgb data.  Single lane only, the data
+        // pointer doesn't move by a fixed amount, so mAdvance is 0.  An empty strip doesn't read the index
+        PixelController(const uint8_t *index, const CRGB *palette, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)(len > 0 ? palette + *index : palette)), mPalette(palette), mIndex(index), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mAdvance = 0;
             initOffsets(len);
@@ -323,8 +379,12 @@ struct PixelController {
         // get the amount to advance the pointer by
         __attribute__((always_inline)) inline int advanceBy() { return mAdvance; }
 
-        // advance the data pointer forward, adjust position counter
-         __attribute__((always_inline)) inline void advanceData() { mData += mAdvance; mLenRemaining--;}
+        // advance the data pointer forward, adjust position counter.  Indexed data looks up the next led
+        // only if there is one, the index array ends at the last led
+         __attribute__((always_inline)) inline void advanceData() {
+             if(mPalette) { if(mLenRemaining > 1) { mData = (const uint8_t*)(mPalette + *++mIndex); } } else { mData += mAdvance; }
+             mLenRemaining--;
+         }
 
         // step the dithering forward
          __attribute__((always_inline)) inline void stepDithering() {
@@ -397,6 +457,16 @@ protected:
     showPixels(pixels);
   }
 
+/// write the passed in indexed color data out to the leds managed by this controller
+///@param index one byte per led, the index of its color in the palette
+///@param palette the colors the index bytes refer to
+///@param nLeds the number of leds being written out
+///@param scale the rgb scaling to apply to each led before writing it out
+  virtual void showIndexed(const uint8_t *index, const CRGB *palette, int nLeds, CRGB scale) {
+    PixelController<RGB_ORDER, LANES, MASK> pixels(index, palette, nLeds, scale, getDither());
+    showPixels(pixels);
+  }
+
 public:
   CPixelLEDController() : CLEDController() {}
 };
@@ -0,0 +1,101 @@
+#include <FastLED.h>
+
+// ArrayKernelsBench - throughput of the array functions nscale8,
+// fadeToBlackBy, nblend and blur1d, against a plain per-pixel loop.
+//
+// No LEDs needed: open the serial monitor at 115200 baud.  Buffers of 1K to
+// 64K pixels are allocated on the heap; sizes that don't fit into RAM are
+// skipped, so on an Uno nothing but the small sizes will run.  On 32-bit
+// boards the array functions use the word-at-a-time kernels from
+// colorutils.cpp; every result is also checked against the per-pixel loop.
+
+const uint16_t sizes[] = { 64, 256, 1024, 4096, 16384, 65535 };
+
+CRGB* leds;
+CRGB* ref;
+CRGB* overlay;
+
+void fillTest( CRGB* p, uint16_t n, uint8_t seed) {
+  random16_set_seed( seed);
+  for( uint16_t i = 0; i < n; i++) p[i] = CRGB( random8(), random8(), random8());
+}
+
+// the per-pixel versions the array functions must match
+void refNscale8( CRGB* p, uint16_t n, uint8_t scale) {
+  for( uint16_t i = 0; i < n; i++) p[i].nscale8( scale);
+}
+void refNblend( CRGB* p, CRGB* o, uint16_t n, uint8_t amount) {
+  for( uint16_t i = 0; i < n; i++) nblend( p[i], o[i], amount);
+}
+void refBlur1d( CRGB* p, uint16_t n, uint8_t amount) {
+  uint8_t keep = 255 - amount;
+  uint8_t seep = amount >> 1;
+  CRGB carryover = CRGB::Black;
+  for( uint16_t i = 0; i < n; i++) {
+    CRGB cur = p[i];
+    CRGB part = cur;
+    part.nscale8( seep);
+    cur.nscale8( keep);
+    cur += carryover;
+    if( i) p[i - 1] += part;
+    p[i] = cur;
+    carryover = part;
+  }
+}
+
+void report( const __FlashStringHelper* name, uint16_t n, uint32_t usRef, uint32_t usArray) {
+  Serial.print( n);
+  Serial.print( F(" px  "));
+  Serial.print( name);
+  Serial.print( F(": loop "));
+  Serial.print( (uint32_t)((uint64_t)n * 1000000 / (usRef ? usRef : 1)));
+  Serial.print( F(" px/s, array "));
+  Serial.print( (uint32_t)((uint64_t)n * 1000000 / (usArray ? usArray : 1)));
+  Serial.print( F(" px/s"));
+  Serial.println( memcmp( leds, ref, (size_t)n * sizeof(CRGB)) ? F("  MISMATCH") : F(""));
+}
+
+void setup() {
+  Serial.begin(115200);
+}
+
+void loop() {
+  for( uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    uint16_t n = sizes[s];
+    uint32_t bytes = (uint32_t)n * sizeof(CRGB);
+    leds = ref = overlay = NULL;
+    if( bytes <= (size_t)-1) {
+      leds = (CRGB*)malloc( bytes);
+      ref = (CRGB*)malloc( bytes);
+      overlay = (CRGB*)malloc( bytes);
+    }
+    if( leds && ref && overlay) {
+      uint32_t t0, t1, t2;
+      fillTest( leds, n, 1); fillTest( ref, n, 1);
+      t0 = micros(); refNscale8( ref, n, 200);
+      t1 = micros(); nscale8( leds, n, 200);
+      t2 = micros(); report( F("nscale8      "), n, t1 - t0, t2 - t1);
+
+      t0 = micros(); refNscale8( ref, n, 255 - 64);
+      t1 = micros(); fadeToBlackBy( leds, n, 64);
+      t2 = micros(); report( F("fadeToBlackBy"), n, t1 - t0, t2 - t1);
+
+      fillTest( overlay, n, 2);
+      t0 = micros(); refNblend( ref, overlay, n, 100);
+      t1 = micros(); nblend( leds, overlay, n, 100);
+      t2 = micros(); report( F("nblend       "), n, t1 - t0, t2 - t1);
+
+      t0 = micros(); refBlur1d( ref, n, 172);
+      t1 = micros(); blur1d( leds, n, 172);
+      t2 = micros(); report( F("blur1d       "), n, t1 - t0, t2 - t1);
+    } else {
+      Serial.print( n);
+      Serial.println( F(" px  skipped, not enough RAM"));
+    }
+    free( overlay);
+    free( ref);
+    free( leds);
+  }
+  Serial.println();
+  delay( 5000);
+}
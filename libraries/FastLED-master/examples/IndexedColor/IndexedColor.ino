@@ -0,0 +1,39 @@
+#define FASTLED_AVR_INDEXED 1      // AVR: build the indexed output loop
+#include <FastLED.h>
+
+// IndexedColor - drives a long strip from an indexed color frame: one byte
+// per led, an index into a small palette, instead of a 3 byte CRGB.  The
+// palette lookup happens as the leds are written out, so 1000 leds take
+// 1000 bytes of RAM plus the palette, which fits next to a sketch on an Uno.
+//
+// The palette can be changed every frame - here it is a rotating rainbow,
+// while the index frame only gets a moving dot drawn into it.  Writing the
+// leds out takes as long as for a CRGB array of the same length.
+
+#define LED_PIN     6
+#define NUM_LEDS    1000
+#define PAL_SIZE    64
+
+uint8_t leds[NUM_LEDS];
+CRGB palette[PAL_SIZE + 1];     // the last entry is the dot
+
+void setup() {
+  FastLED.addLeds<WS2812B, LED_PIN, GRB>(NULL, NUM_LEDS).setLedsIndexed(leds, palette, NUM_LEDS);
+  FastLED.setBrightness(64);
+  for( uint16_t i = 0; i < NUM_LEDS; i++) leds[i] = (uint32_t)i * PAL_SIZE / NUM_LEDS;
+}
+
+void loop() {
+  static uint8_t hue = 0;
+  static uint16_t dot = 0;
+
+  for( uint8_t i = 0; i < PAL_SIZE; i++) palette[i] = CHSV( hue + i * (256 / PAL_SIZE), 255, 255);
+  palette[PAL_SIZE] = CRGB::White;
+  hue++;
+
+  leds[dot] = (uint32_t)dot * PAL_SIZE / NUM_LEDS;   // put the rainbow back under the old dot
+  if( ++dot >= NUM_LEDS) dot = 0;
+  leds[dot] = PAL_SIZE;
+
+  FastLED.show();
+}
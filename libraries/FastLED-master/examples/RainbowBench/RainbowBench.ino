@@ -0,0 +1,81 @@
+#include <FastLED.h>
+
+// RainbowBench - compares hsv2rgb_rainbow() called once per pixel with the
+// batch overload hsv2rgb_rainbow( CHSV*, CRGB*, count).
+//
+// No LEDs needed: open the serial monitor at 115200 baud.  The sketch first
+// checks that both paths give identical colors for every hue and saturation
+// at a set of brightness levels (including in-place conversion), then prints
+// pixels per second for a rainbow at full brightness, a rainbow with varying
+// brightness (like a spectrum display), and random colors.
+
+#define NUM_LEDS 128     // three buffers of this size must fit into 2K of RAM
+#define RUNS     50
+
+CHSV hsv[NUM_LEDS];
+CRGB rgb[NUM_LEDS];
+CRGB ref[NUM_LEDS];
+
+const uint8_t check_vals[] = { 0, 1, 2, 64, 127, 128, 200, 254, 255 };
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("hsv2rgb_rainbow batch check"));
+
+  uint32_t mismatches = 0;
+  for( uint8_t v = 0; v < sizeof(check_vals); v++) {
+    for( uint16_t hs = 0; hs < 512; hs++) {
+      // two passes of 128 hues for each saturation
+      for( uint16_t i = 0; i < NUM_LEDS; i++) {
+        hsv[i] = CHSV( i + (hs & 1) * 128, hs >> 1, check_vals[v]);
+        hsv2rgb_rainbow( hsv[i], ref[i]);
+      }
+      hsv2rgb_rainbow( hsv, rgb, NUM_LEDS);
+      for( uint16_t i = 0; i < NUM_LEDS; i++) {
+        if( rgb[i] != ref[i]) mismatches++;
+      }
+      // in place: the CHSV values are stored in the CRGB array itself
+      memcpy( (void*)rgb, hsv, sizeof(hsv));
+      hsv2rgb_rainbow( (CHSV*)rgb, rgb, NUM_LEDS);
+      for( uint16_t i = 0; i < NUM_LEDS; i++) {
+        if( rgb[i] != ref[i]) mismatches++;
+      }
+    }
+  }
+  Serial.print(F("mismatches: "));
+  Serial.println(mismatches);
+}
+
+void bench(const __FlashStringHelper* name) {
+  uint32_t t0 = micros();
+  for( uint8_t r = 0; r < RUNS; r++) {
+    for( uint16_t i = 0; i < NUM_LEDS; i++) hsv2rgb_rainbow( hsv[i], rgb[i]);
+  }
+  uint32_t t1 = micros();
+  for( uint8_t r = 0; r < RUNS; r++) {
+    hsv2rgb_rainbow( hsv, rgb, NUM_LEDS);
+  }
+  uint32_t t2 = micros();
+
+  uint32_t pixels = (uint32_t)RUNS * NUM_LEDS;
+  Serial.print(name);
+  Serial.print(F(": per pixel "));
+  Serial.print(pixels * 1000UL / ((t1 - t0) / 1000UL));
+  Serial.print(F(" px/s, batch "));
+  Serial.print(pixels * 1000UL / ((t2 - t1) / 1000UL));
+  Serial.println(F(" px/s"));
+}
+
+void loop() {
+  for( uint16_t i = 0; i < NUM_LEDS; i++) hsv[i] = CHSV( i * 2, 255, 255);
+  bench( F("rainbow"));
+
+  for( uint16_t i = 0; i < NUM_LEDS; i++) hsv[i] = CHSV( i * 2, 255, sin8( i * 6));
+  bench( F("rainbow, varying value"));
+
+  for( uint16_t i = 0; i < NUM_LEDS; i++) hsv[i] = CHSV( random8(), random8(), random8());
+  bench( F("random"));
+
+  Serial.println();
+  delay(2000);
+}
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+# Host check of the AVR clockless output loops in platforms/avr/clockless_trinket.h, no avr-gcc needed.
+#
+# showRGBInternal and showIndexedInternal are expanded with the C preprocessor into flat asm listings,
+# which run on a small cycle-counting AVR model that records every write to the port.  For random
+# palettes, scales and dither values, 1-40 leds, and WS2812/WS2811/SK6812/LPD1886 timings at 8 and
+# 16Mhz it checks that:
+#  - the indexed loop sends the same bits as showRGBInternal fed the equivalent CRGB array
+#  - every high phase is the same length in both loops
+#  - at 16Mhz WS2812, WS2811 and SK6812 get cycle-identical low phases too
+# and prints the bits whose low phase runs long elsewhere.  The XTRA0 rows (slow chipsets only) and
+# the register allocation are not modelled, the model gives every asm operand its own register.
+#
+# run from this folder (needs cpp on the path):
+#   python3 clockless_trinket_test.py
+import os, random, re, subprocess, sys
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'platforms', 'avr', 'clockless_trinket.h')
+
+# chipset timings T1, T2, T3 in cycles at 8Mhz, doubled for 16Mhz - see chipsets.h
+CHIPSETS = {'WS2812': (2, 5, 3), 'WS2811': (3, 4, 3), 'SK6812': (3, 3, 4), 'LPD1886': (2, 3, 2)}
+EXACT_16MHZ = ('WS2812', 'WS2811', 'SK6812')
+
+# register of each asm operand in the model: pointers where the constraints put them (Z, X, r24)
+REG = {'data': 30, 'index': 26, 'count': 24, 'b0': 16, 'b1': 17, 'scale_base': 18, 'loopvar': 19,
+       'd0': 20, 'd1': 21, 'd2': 22, 'e0': 23, 'e1': 11, 'e2': 12, 's0': 2, 's1': 3, 's2': 4,
+       'cidx': 5, 'pal': 6, 'ADV': 8, 'hi': 9, 'lo': 10}
+PAIRS = ('data', 'index', 'count', 'pal')
+CONST = {'O0': 0, 'O1': 1, 'O2': 2}
+
+
+def expand(hdr, func):
+    """flat asm listing of func's output loop, from its first byte to ENDLOOP5"""
+    lines = hdr.split('\n')
+    # the helper macros before showRGBInternal, plus the indexed ones
+    start = next(i for i, l in enumerate(lines) if l.startswith('// Note: the code in the else in HI1/LO1'))
+    end = next(i for i, l in enumerate(lines) if 'showRGBInternal(PixelController' in l)
+    macros = '\n'.join(lines[start:end])
+    im = hdr.index('#define ASM_VARS_INDEXED_W , [index]')
+    macros += '\n' + hdr[im:hdr.index('// The same loop as showRGBInternal', im)]
+    m = re.search(r'static void[^\n]*\b%s\(' % func, hdr)
+    b = hdr.index('b0 = data[RO(0)];', m.start())
+    body = hdr[b + len('b0 = data[RO(0)];'):hdr.index('ENDLOOP5', b) + 8]
+    body = re.sub(r'switch\(XTRA0\) \{.*?\}', '', body, flags=re.S)
+    src = '''#define DITHER 1
+#define ASM_VARS
+#define ASM_VARS_INDEXED_W
+#define ASM_VARS_INDEXED_R
+%s
+#undef HI1
+#undef LO1
+#undef DINT
+#define HI1 asm __volatile__("out PORT, %%[hi]");
+#define LO1 asm __volatile__("out PORT, %%[lo]");
+#define DINT(T,ADJ) asm __volatile__("DELAY " #T " " #ADJ);
+#define D1(ADJ) DINT(T1,ADJ)
+#define D2(ADJ) DINT(T2,ADJ)
+#define D3(ADJ) DINT(T3,ADJ)
+%s
+''' % (macros, body)
+    out = subprocess.run(['cpp', '-P'], input=src, capture_output=True, text=True, check=True).stdout
+    n = 0
+    prog, labels = [], {}
+    for m in re.finditer(r'asm\s+__volatile(?:__)?\s*\(((?:\s*"(?:[^"\\]|\\.)*")+)', out):
+        n += 1
+        s = ''.join(re.findall(r'"((?:[^"\\]|\\.)*)"', m.group(1))).replace('%=', str(n))
+        for ins in s.split('\\n'):
+            ins = ins.replace('\\t', ' ').strip()
+            lm = re.match(r'^(\w+):$', ins)
+            if lm:
+                labels.setdefault(lm.group(1), []).append(len(prog))
+            elif ins:
+                prog.append(ins)
+    return prog, labels
+
+
+def run(listing, T, mem, regs):
+    """run the listing until it falls off the end, return the port writes as (cycle, value)"""
+    prog, labels = listing
+    r = [0] * 32
+    for k, v in regs.items():
+        r[REG[k]] = v & 0xff
+        if k in PAIRS:
+            r[REG[k] + 1] = (v >> 8) & 0xff
+    C = Z = 0
+    cyc = pc = steps = 0
+    edges = []
+
+    def reg(t):
+        t = t.strip()
+        if t == '__zero_reg__':
+            return 1
+        m = re.match(r'%([AB])?\[(\w+)\]$', t)
+        if m:
+            return REG[m.group(2)] + (1 if m.group(1) == 'B' else 0)
+        return int(t[1:])
+
+    def const(t):
+        t = t.strip()
+        m = re.match(r'%\[(\w+)\]$', t)
+        return CONST[m.group(1)] if m else int(t, 0)
+
+    def p16(b):
+        return r[b] | (r[b + 1] << 8)
+
+    def s16(b, v):
+        r[b] = v & 0xff
+        r[b + 1] = (v >> 8) & 0xff
+
+    while pc < len(prog):
+        steps += 1
+        assert steps < 10 ** 6
+        ins = prog[pc]
+        op, _, args = ins.partition(' ')
+        op = op.lower()
+        a = [x.strip() for x in args.split(',')] if args.strip() else []
+        nxt = pc + 1
+        cy = 1
+        if op == 'delay':
+            cy = max(0, T[a[0].split()[0]] - (1 + int(ins.split()[2])))
+        elif op == 'out':
+            edges.append((cyc, r[reg(a[1])]))
+        elif op in ('sbrs', 'sbrc'):
+            if ((r[reg(a[0])] >> int(a[1])) & 1) == (op == 'sbrs'):
+                nxt = pc + 2
+                cy = 2
+        elif op == 'cpse':
+            if r[reg(a[0])] == r[reg(a[1])]:
+                nxt = pc + 2
+                cy = 2
+        elif op == 'ldd':
+            base, off = a[1].split('+')
+            assert base.strip() == 'Z'
+            r[reg(a[0])] = mem.get(p16(30) + const(off), 0)
+            cy = 2
+        elif op == 'ld':
+            m = re.match(r'%a\[(\w+)\]\+$', a[1])
+            p = REG[m.group(1)]
+            assert p in (26, 28, 30)
+            r[reg(a[0])] = mem.get(p16(p), 0)
+            s16(p, p16(p) + 1)
+            cy = 2
+        elif op == 'clr':
+            r[reg(a[0])] = 0
+            Z = 1
+        elif op == 'clc':
+            C = 0
+        elif op == 'mov':
+            r[reg(a[0])] = r[reg(a[1])]
+        elif op == 'movw':
+            d, q = reg(a[0]), reg(a[1])
+            r[d], r[d + 1] = r[q], r[q + 1]
+        elif op == 'ldi':
+            r[reg(a[0])] = const(a[1])
+        elif op in ('add', 'adc'):
+            d = reg(a[0])
+            v = r[d] + r[reg(a[1])] + (C if op == 'adc' else 0)
+            C = v >> 8
+            r[d] = v & 0xff
+            Z = int(r[d] == 0)
+        elif op == 'ror':
+            d = reg(a[0])
+            v = r[d]
+            r[d] = (v >> 1) | (C << 7)
+            C = v & 1
+            Z = int(r[d] == 0)
+        elif op == 'neg':
+            d = reg(a[0])
+            v = (-r[d]) & 0xff
+            C = int(v != 0)
+            r[d] = v
+            Z = int(v == 0)
+        elif op == 'sbiw':
+            d = reg(a[0])
+            assert d in (24, 26, 28, 30)
+            v = p16(d) - int(a[1])
+            C = int(v < 0)
+            v &= 0xffff
+            s16(d, v)
+            Z = int(v == 0)
+            cy = 2
+        elif op in ('brcc', 'brcs', 'breq', 'brne', 'rjmp'):
+            if {'brcc': not C, 'brcs': C, 'breq': Z, 'brne': not Z, 'rjmp': True}[op]:
+                cy = 2
+                t = a[0]
+                if t == '.+0':
+                    nxt = pc + 1
+                elif t.endswith('b'):
+                    nxt = max(l for l in labels[t[:-1]] if l <= pc)
+                else:
+                    nxt = labels[t][0]
+        else:
+            raise Exception('unknown instruction ' + ins)
+        cyc += cy
+        pc = nxt
+    return edges
+
+
+def bits(edges, hi):
+    """(high cycles, low cycles) of every bit, a bit starts at each write of hi"""
+    starts = [i for i, (c, v) in enumerate(edges) if v == hi]
+    out = []
+    for k, i in enumerate(starts):
+        t0 = edges[i][0]
+        fall = next((c for c, v in edges[i + 1:] if v != hi), None)
+        t1 = edges[starts[k + 1]][0] if k + 1 < len(starts) else None
+        out.append((fall - t0, (t1 - fall) if t1 is not None else None))
+    return out
+
+
+def decode(b, T):
+    """bytes as the chip reads them: a long high phase is a 1"""
+    thr = (T['T1'] + T['T1'] + T['T2']) / 2
+    v = [int(h > thr) for h, l in b]
+    return [sum(v[i + j] << (7 - j) for j in range(8)) for i in range(0, len(v), 8)]
+
+
+def main():
+    hdr = open(HEADER).read()
+    rgb, idx = expand(hdr, 'showRGBInternal'), expand(hdr, 'showIndexedInternal')
+    random.seed(1)
+    fails = 0
+    for fmul in (1, 2):
+        for name, t in CHIPSETS.items():
+            T = {'T1': t[0] * fmul, 'T2': t[1] * fmul, 'T3': t[2] * fmul}
+            longer = set()
+            for trial in range(20):
+                n = random.randint(1, 40)
+                pal = [random.randrange(256) for _ in range(3 * 85)]
+                # one index past the end: the last led loads it and never uses it
+                index = [random.randrange(85) for _ in range(n + 1)]
+                common = dict(count=n, hi=1, lo=0, ADV=3)
+                for k in ('s0', 's1', 's2', 'd0', 'd1', 'd2', 'e0', 'e1', 'e2'):
+                    common[k] = random.randrange(256)
+                rgbmem = {0x200 + 3 * i + j: pal[3 * index[i] + j] for i in range(n) for j in range(3)}
+                imem = {0x700 + k: v for k, v in enumerate(pal)}
+                imem.update({0x600 + i: v for i, v in enumerate(index)})
+                br = bits(run(rgb, T, rgbmem, dict(common, data=0x200)), 1)
+                bi = bits(run(idx, T, imem, dict(common, data=0x700 + 3 * index[0], index=0x601, pal=0x700)), 1)
+                ok = len(br) == len(bi) == 24 * n and decode(br, T) == decode(bi, T)
+                ok = ok and all(br[k][0] == bi[k][0] for k in range(len(br)))
+                if not ok:
+                    print('%2dMhz %-8s trial %d: indexed output differs from rgb' % (8 * fmul, name, trial))
+                    fails += 1
+                    continue
+                longer |= {(k % 24, br[k][1], bi[k][1]) for k in range(len(br) - 1) if br[k][1] != bi[k][1]}
+            if fmul == 2 and name in EXACT_16MHZ and longer:
+                print('%2dMhz %-8s low phases differ: %s' % (8 * fmul, name, sorted(longer)))
+                fails += 1
+            print('%2dMhz %-8s same bits, longer low phases (bit, rgb, indexed): %s'
+                  % (8 * fmul, name, sorted(longer) or '-'))
+    print('%d checks failed' % fails if fails else 'ok')
+    return 1 if fails else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
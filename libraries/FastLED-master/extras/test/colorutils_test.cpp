@@ -0,0 +1,171 @@
+// Host test of the word-at-a-time (COLORUTILS_SWAR) array kernels in colorutils.cpp.
+//
+// colorutils.cpp is built into this test as is, which on a little-endian host takes the SWAR paths.
+// They are compared against the scalar_ functions below, the per-pixel loops of the COLORUTILS_SWAR 0
+// branches (what AVR and big-endian targets run), built on the same CRGB and lib8tion primitives.
+// nscale8 and nblend are compared for every value, scale/amount and byte position in the 32-bit
+// word, blur1d for every amount on random strips, and all of them on random lengths, alignments
+// and amounts, including the bytes just outside the strip.
+// FASTLED_SCALE8_FIXED and FASTLED_BLEND_FIXED are as set in fastled_config.h.
+//
+// build and run from this folder:
+//   g++ -std=gnu++11 -O2 -Wall -Wno-class-memaccess -I. -I../.. colorutils_test.cpp -o colorutils_test && ./colorutils_test
+#include <stdio.h>
+#include <stdlib.h>
+#include "host.h"
+
+#include "colorutils.cpp"
+#include "hsv2rgb.cpp"
+static_assert(COLORUTILS_SWAR == 1, "the host is expected to take the SWAR path");
+
+// the #else branches of nscale8, nblend and blur1d in colorutils.cpp
+void scalar_nscale8(CRGB* leds, uint16_t num_leds, uint8_t scale) {
+	for (uint16_t i = 0; i < num_leds; i++) {
+		leds[i].nscale8(scale);
+	}
+}
+
+void scalar_fadeToBlackBy(CRGB* leds, uint16_t num_leds, uint8_t fadeBy) {
+	scalar_nscale8(leds, num_leds, 255 - fadeBy);
+}
+
+void scalar_nblend(CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOverlay) {
+	for (uint16_t i = count; i; i--) {
+		nblend(*existing, *overlay, amountOfOverlay);
+		existing++;
+		overlay++;
+	}
+}
+
+void scalar_blur1d(CRGB* leds, uint16_t numLeds, fract8 blur_amount) {
+	uint8_t keep = 255 - blur_amount;
+	uint8_t seep = blur_amount >> 1;
+	CRGB carryover = CRGB::Black;
+	for (uint16_t i = 0; i < numLeds; i++) {
+		CRGB cur = leds[i];
+		CRGB part = cur;
+		part.nscale8(seep);
+		cur.nscale8(keep);
+		cur += carryover;
+		if (i) leds[i - 1] += part;
+		leds[i] = cur;
+		carryover = part;
+	}
+}
+
+uint16_t XY(uint8_t x, uint8_t y) { return y * 16 + x; }
+
+static int fails;
+
+#define CHECK(x, what, n, amount) do { if (!(x)) { printf("%s:%d: %s differs (%d leds, amount %d)\n", __FILE__, __LINE__, what, (int)(n), (int)(amount)); fails++; } } while (0)
+
+// two copies of a buffer, the strip starts 'off' bytes in, so every byte position in a word is hit
+#define GUARD 8
+struct Pair {
+	uint8_t *a, *b;
+	uint32_t size;
+	Pair(uint32_t bytes) : size(bytes + 2 * GUARD + 4) { a = (uint8_t*)malloc(size); b = (uint8_t*)malloc(size); }
+	~Pair() { free(a); free(b); }
+	CRGB *swar(uint8_t off) { return (CRGB*)(a + GUARD + off); }
+	CRGB *ref(uint8_t off) { return (CRGB*)(b + GUARD + off); }
+	void sync() { memcpy(b, a, size); }
+	bool same() { return memcmp(a, b, size) == 0; }
+};
+
+void testNscale8All() {
+	// bytes 0..255 across 255 leds: each value lands on every byte position of a word
+	Pair p(3 * 255);
+	for (uint8_t off = 0; off < 4; off++) {
+		for (int scale = 0; scale < 256; scale++) {
+			for (uint32_t i = 0; i < p.size; i++) p.a[i] = i;
+			p.sync();
+			nscale8(p.swar(off), 255, scale);
+			scalar_nscale8(p.ref(off), 255, scale);
+			CHECK(p.same(), "nscale8", 255, scale);
+		}
+	}
+}
+
+void testNblendAll() {
+	// every (existing, overlay) byte pair, for every amount
+	const uint16_t n = 21846;
+	Pair e(3 * n), o(3 * n);
+	for (int amount = 0; amount < 256; amount++) {
+		uint8_t off = amount & 3;
+		for (uint32_t i = 0; i < e.size; i++) {
+			e.a[i] = i;
+			o.a[i] = i >> 8;
+		}
+		e.sync();
+		nblend(e.swar(off), o.swar(3 - off), n, amount);
+		scalar_nblend(e.ref(off), o.swar(3 - off), n, amount);
+		CHECK(e.same(), "nblend", n, amount);
+	}
+}
+
+void fillRandom(Pair &p) {
+	for (uint32_t i = 0; i < p.size; i++) p.a[i] = (rand() % 5 == 0) ? 255 : rand();
+	p.sync();
+}
+
+void testBlur1dAll() {
+	Pair p(3 * 64);
+	for (int amount = 0; amount < 256; amount++) {
+		for (uint16_t n = 0; n <= 64; n += (n < 8) ? 1 : 7) {
+			uint8_t off = rand() & 3;
+			fillRandom(p);
+			blur1d(p.swar(off), n, amount);
+			scalar_blur1d(p.ref(off), n, amount);
+			CHECK(p.same(), "blur1d", n, amount);
+		}
+	}
+}
+
+void testRandom() {
+	Pair p(3 * 40), o(3 * 40);
+	for (int iter = 0; iter < 20000; iter++) {
+		uint16_t n = rand() % 41;
+		uint8_t off = rand() & 3, ooff = rand() & 3;
+		uint8_t amount = (iter % 7 == 0) ? 0 : (iter % 11 == 0) ? 255 : rand();
+		fillRandom(p);
+		fillRandom(o);
+		switch (iter % 5) {
+			case 0:
+				nscale8(p.swar(off), n, amount);
+				scalar_nscale8(p.ref(off), n, amount);
+				CHECK(p.same(), "nscale8", n, amount);
+				break;
+			case 1:
+				fadeToBlackBy(p.swar(off), n, amount);
+				scalar_fadeToBlackBy(p.ref(off), n, amount);
+				CHECK(p.same(), "fadeToBlackBy", n, amount);
+				break;
+			case 2:
+				nblend(p.swar(off), o.swar(ooff), n, amount);
+				scalar_nblend(p.ref(off), o.swar(ooff), n, amount);
+				CHECK(p.same(), "nblend", n, amount);
+				break;
+			case 3:
+				blur1d(p.swar(off), n, amount);
+				scalar_blur1d(p.ref(off), n, amount);
+				CHECK(p.same(), "blur1d", n, amount);
+				break;
+			case 4:
+				nscale8_raw(p.swar(off), n, amount);
+				scalar_nscale8(p.ref(off), n, amount);
+				CHECK(p.same(), "nscale8_raw", n, amount);
+				break;
+		}
+	}
+}
+
+int main() {
+	srand(1);
+	testNscale8All();
+	testNblendAll();
+	testBlur1dAll();
+	testRandom();
+	if (fails) printf("%d checks failed\n", fails);
+	else printf("ok\n");
+	return fails ? 1 : 0;
+}
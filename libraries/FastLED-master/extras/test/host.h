@@ -0,0 +1,27 @@
+// Host build of the FastLED color code, for the tests in this folder.  FastLED.h itself and the
+// platform headers (pins, controllers, chipsets) are kept out through their include guards, the
+// pixel types, lib8tion (its plain C paths), the color and noise functions come in as they are.
+#ifndef __INC_FASTLED_HOST_TEST_H
+#define __INC_FASTLED_HOST_TEST_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define __INC_FASTSPI_LED2_H
+#define __INC_LED_SYSDEFS_H
+#define FASTLED_NAMESPACE_BEGIN
+#define FASTLED_NAMESPACE_END
+#define FASTLED_USING_NAMESPACE
+
+#include "cpp_compat.h"
+#include "fastled_config.h"
+#include "fastled_progmem.h"
+#include "lib8tion.h"
+#include "pixeltypes.h"
+#include "hsv2rgb.h"
+#include "colorutils.h"
+#include "colorpalettes.h"
+#include "noise.h"
+
+#endif
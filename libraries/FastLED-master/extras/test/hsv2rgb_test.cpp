@@ -0,0 +1,153 @@
+// Host test of the array hsv2rgb_rainbow( CHSV*, CRGB*, count) in hsv2rgb.cpp.
+//
+// Checks it against the per-pixel hsv2rgb_rainbow for all 2^24 hue/sat/val inputs, into a
+// separate array and in place.  table_rainbow below is the table-driven batch kernel that was
+// tried for the array version: it is checked the same way, and pixels/second of the per-pixel
+// loop and of the table kernel are printed for the same three loads as the RainbowBench example.
+// The numbers are for the host CPU.  The table kernel came out slower (0.4-0.5x at -Os, 0.9-1.0x
+// at -O2), so the library keeps the per-pixel loop.
+//
+// build and run from this folder:
+//   g++ -std=gnu++11 -Os -Wall -Wno-class-memaccess -I. -I../.. hsv2rgb_test.cpp -o hsv2rgb_test && ./hsv2rgb_test
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "host.h"
+
+#include "hsv2rgb.cpp"
+
+// For each of the eight hue sections and each of r, g, b: the base value, then the multiplier of
+// 'third' and of 'twothirds' (0, 1, or 255 meaning -1).  The Y1 / no-G2 / no-Gscale formulas of
+// hsv2rgb_rainbow.
+static const uint8_t rainbow_sections[8][9] = {
+	//  r: base third 2/3    g: base third 2/3    b: base third 2/3
+	{  K255, 255,   0,         0,    1,   0,         0,    0,   0 }, // R -> O
+	{  K171,   0,   0,       K85,    1,   0,         0,    0,   0 }, // O -> Y
+	{  K171,   0, 255,      K170,    1,   0,         0,    0,   0 }, // Y -> G
+	{     0,   0,   0,      K255,  255,   0,         0,    1,   0 }, // G -> A
+	{     0,   0,   0,      K171,    0, 255,       K85,    0,   1 }, // A -> B
+	{     0,   1,   0,         0,    0,   0,      K255,  255,   0 }, // B -> P
+	{   K85,   1,   0,         0,    0,   0,      K171,  255,   0 }, // P -> K
+	{  K170,   1,   0,         0,    0,   0,       K85,  255,   0 }  // K -> R
+};
+
+static inline uint8_t section_channel(const uint8_t *k, uint8_t third, uint8_t twothirds) {
+	return k[0] + (uint8_t)(k[1] * third) + (uint8_t)(k[2] * twothirds);
+}
+
+// saturation and value without the per-channel zero tests, 'white' and 'lit' are 0x00/0xFF masks
+// for the non-FIXED scale8 rounding
+static inline uint8_t sat_channel(uint8_t x, uint8_t sat, uint8_t brightness_floor, uint8_t white) {
+#if (FASTLED_SCALE8_FIXED == 1)
+	return scale8(x, sat) + brightness_floor;
+#else
+	return (scale8(x, sat) + (x != 0) + brightness_floor) | white;
+#endif
+}
+
+static inline uint8_t val_channel(uint8_t x, uint8_t val, uint8_t lit) {
+#if (FASTLED_SCALE8_FIXED == 1)
+	return scale8(x, val);
+#else
+	return (scale8(x, val) + (x != 0)) & lit;
+#endif
+}
+
+void table_rainbow(const CHSV *phsv, CRGB *prgb, int numLeds) {
+	for (int i = 0; i < numLeds; i++) {
+		uint8_t hue = phsv[i].hue;
+		uint8_t sat = phsv[i].sat;
+		uint8_t val = phsv[i].val;
+
+		uint8_t offset8 = (hue & 0x1F) << 3;
+		uint8_t third = scale8(offset8, (256 / 3));
+		uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+		const uint8_t *k = rainbow_sections[hue >> 5];
+		uint8_t r = section_channel(k, third, twothirds);
+		uint8_t g = section_channel(k + 3, third, twothirds);
+		uint8_t b = section_channel(k + 6, third, twothirds);
+
+		if (sat != 255) {
+			uint8_t desat = 255 - sat;
+			uint8_t brightness_floor = scale8(desat, desat);
+			uint8_t white = -(uint8_t)(sat == 0);
+			r = sat_channel(r, sat, brightness_floor, white);
+			g = sat_channel(g, sat, brightness_floor, white);
+			b = sat_channel(b, sat, brightness_floor, white);
+		}
+		if (val != 255) {
+			val = scale8_video(val, val);
+			uint8_t lit = -(uint8_t)(val != 0);
+			r = val_channel(r, val, lit);
+			g = val_channel(g, val, lit);
+			b = val_channel(b, val, lit);
+		}
+		prgb[i].r = r;
+		prgb[i].g = g;
+		prgb[i].b = b;
+	}
+}
+
+static int fails;
+
+#define CHECK(x, hue, sat, val) do { if (!(x)) { if (fails < 10) printf("%s:%d: %s for CHSV(%d, %d, %d)\n", __FILE__, __LINE__, #x, hue, sat, val); fails++; } } while (0)
+
+void testAll() {
+	// one hue/sat plane per value
+	static CHSV hsv[65536];
+	static CRGB rgb[65536], ref[65536], inplace[65536], table[65536];
+	for (int val = 0; val < 256; val++) {
+		for (int i = 0; i < 65536; i++) {
+			hsv[i] = CHSV(i & 0xFF, i >> 8, val);
+			hsv2rgb_rainbow(hsv[i], ref[i]);
+		}
+		hsv2rgb_rainbow(hsv, rgb, 65536);
+		memcpy((void*)inplace, hsv, sizeof(hsv));
+		hsv2rgb_rainbow((CHSV*)inplace, inplace, 65536);
+		table_rainbow(hsv, table, 65536);
+		for (int i = 0; i < 65536; i++) {
+			CHECK(rgb[i] == ref[i], i & 0xFF, i >> 8, val);
+			CHECK(inplace[i] == ref[i], i & 0xFF, i >> 8, val);
+			CHECK(table[i] == ref[i], i & 0xFF, i >> 8, val);
+		}
+	}
+}
+
+#define BENCH_LEDS 1024
+#define BENCH_RUNS 20000
+
+void bench(const char *name, const CHSV *hsv) {
+	static CRGB rgb[BENCH_LEDS];
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < BENCH_RUNS; r++) {
+		hsv2rgb_rainbow(hsv, rgb, BENCH_LEDS);
+		asm volatile("" : : "r"(rgb) : "memory");
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	for (int r = 0; r < BENCH_RUNS; r++) {
+		table_rainbow(hsv, rgb, BENCH_LEDS);
+		asm volatile("" : : "r"(rgb) : "memory");
+	}
+	auto t2 = std::chrono::steady_clock::now();
+	double pixels = (double)BENCH_LEDS * BENCH_RUNS;
+	double single = pixels / std::chrono::duration<double>(t1 - t0).count();
+	double batch = pixels / std::chrono::duration<double>(t2 - t1).count();
+	printf("%-24s per pixel %7.1f Mpx/s, table %7.1f Mpx/s (x%.2f)\n", name, single / 1e6, batch / 1e6, batch / single);
+}
+
+int main() {
+	testAll();
+
+	static CHSV hsv[BENCH_LEDS];
+	for (int i = 0; i < BENCH_LEDS; i++) hsv[i] = CHSV(i * 2, 255, 255);
+	bench("rainbow", hsv);
+	for (int i = 0; i < BENCH_LEDS; i++) hsv[i] = CHSV(i * 2, 255, sin8(i * 6));
+	bench("rainbow, varying value", hsv);
+	srand(1);
+	for (int i = 0; i < BENCH_LEDS; i++) hsv[i] = CHSV(rand(), rand(), rand());
+	bench("random", hsv);
+
+	if (fails) printf("%d checks failed\n", fails);
+	else printf("ok\n");
+	return fails ? 1 : 0;
+}
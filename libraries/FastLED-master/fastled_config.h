@@ -52,5 +52,12 @@
 #define FASTLED_INTERRUPT_RETRY_COUNT 2
 #endif
 
+// Use this to turn on indexed color output (CLEDController::setLedsIndexed) on AVR.  The clockless
+// chipsets then carry a second copy of their output loop in flash, so it's off by default, and
+// setLedsIndexed doesn't compile while it's off.
+#ifndef FASTLED_AVR_INDEXED
+#define FASTLED_AVR_INDEXED 0
+#endif
+
 
 #endif
@@ -501,6 +501,11 @@ void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
     }
 }
 
+// The per-pixel version reads hue, sat and val before it writes, so the
+// array version can convert in place (phsv and prgb the same memory).
+// A table-driven batch kernel was measured slower than this loop, at
+// 0.4-0.5x the speed with -Os on the host (extras/test/hsv2rgb_test.cpp);
+// on AVR it needs 9 LPM and 6 multiplies per pixel.
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
     for(int i = 0; i < numLeds; i++) {
         hsv2rgb_rainbow(phsv[i], prgb[i]);
@@ -14,6 +14,9 @@ FASTLED_NAMESPACE_BEGIN
 //                   than a straight 'spectrum'.
 //
 //                   NOTE: here hue is 0-255, not just 0-191
+//
+//                   The array version may be called in place, with phsv
+//                   and prgb pointing to the same array.
 
 void hsv2rgb_rainbow( const struct CHSV& hsv, struct CRGB& rgb);
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds);
@@ -557,7 +557,8 @@ void fill_raw_noise16into8(uint8_t *pData, uint8_t num_points, uint8_t octaves,
   uint32_t _xx = x;
   uint32_t scx = scale;
   for(int o = 0; o < octaves; o++) {
-    for(int i = 0,xx=_xx; i < num_points; i++, xx+=scx) {
+    uint32_t xx = _xx;
+    for(int i = 0; i < num_points; i++, xx+=scx) {
       uint32_t accum = (inoise16(xx,time))>>o;
       accum += (pData[i]<<8);
       if(accum > 65535) { accum = 65535; }
@@ -16,6 +16,7 @@ FASTLED_NAMESPACE_BEGIN
 #define DITHER 1
 #endif
 
+
 #if (F_CPU==8000000)
 #define FASTLED_SLOW_CLOCK_ADJUST // asm __volatile__ ("mov r0,r0\n\t");
 #else
@@ -111,6 +112,11 @@ protected:
 		mWait.wait();
 		cli();
 
+#if (FASTLED_AVR_INDEXED == 1)
+		if(pixels.mPalette) {
+			showIndexedInternal(pixels);
+		} else
+#endif
 		showRGBInternal(pixels);
 
 		// Adjust the timer
@@ -170,7 +176,7 @@ protected:
 // The variables that our various asm statemetns use.  The same block of variables needs to be declared for
 // all the asm blocks because GCC is pretty stupid and it would clobber variables happily or optimize code away too aggressively
 #define ASM_VARS : /* write variables */				\
-				[count] "+x" (count),					\
+				[count] ASM_VARS_COUNT (count),			\
 				[data] "+z" (data),						\
 				[b1] "+a" (b1),							\
 				[d0] "+r" (d0),							\
@@ -178,6 +184,7 @@ protected:
 				[d2] "+r" (d2),							\
 				[loopvar] "+a" (loopvar),				\
 				[scale_base] "+a" (scale_base)			\
+				ASM_VARS_INDEXED_W						\
 				: /* use variables */					\
 				[ADV] "r" (advanceBy),					\
 				[b0] "a" (b0),							\
@@ -193,8 +200,15 @@ protected:
 				[O0] "M" (RGB_BYTE0(RGB_ORDER)),		\
 				[O1] "M" (RGB_BYTE1(RGB_ORDER)),		\
 				[O2] "M" (RGB_BYTE2(RGB_ORDER))		\
+				ASM_VARS_INDEXED_R						\
 				: "cc" /* clobber registers */
 
+// extra variables for the indexed color loop, empty for rgb data
+#define ASM_VARS_INDEXED_W
+#define ASM_VARS_INDEXED_R
+// the led counter lives in X for rgb data, the indexed loop needs X for the index pointer
+#define ASM_VARS_COUNT "+x"
+
 
 // Note: the code in the else in HI1/LO1 will be turned into an sts (2 cycle, 2 word) opcode
 // 1 cycle, write hi to the port
@@ -455,6 +469,164 @@ protected:
 		#endif
 	}
 
+#if (FASTLED_AVR_INDEXED == 1)
+#undef ASM_VARS_INDEXED_W
+#undef ASM_VARS_INDEXED_R
+#undef ASM_VARS_COUNT
+// index takes X, so Y stays free for the frame pointer, and count goes to any sbiw pair (r24 when Y is the frame)
+#define ASM_VARS_INDEXED_W , [index] "+x" (index), [cidx] "+r" (cidx)
+#define ASM_VARS_INDEXED_R , [pal] "r" (pal)
+#define ASM_VARS_COUNT "+w"
+
+// Clamp for prescale, clear carry - the middle byte doesn't move the data pointer here, see LDIDX3/ADDIDX2
+#if (DITHER==1)
+#define PSBCLC4(D) asm __volatile__("brcc L_%=\n\tldi %[scale_base], 0xFF\n\tL_%=:\n\tclc\n\tmov r0,r0\n\t" ASM_VARS);
+#else
+#define PSBCLC4(D) asm __volatile__("clc\n\tmov r0,r0\n\trjmp .+0\n\t" ASM_VARS);
+#endif
+// 3 cycles - load the next led's palette index, point data at the palette
+#define LDIDX3 asm __volatile__("ld %[cidx], %a[index]+\n\tmovw %A[data], %A[pal]\n\t" ASM_VARS);
+// 2 cycles - add the index to data, three of these step over 3 bytes per palette entry.  Never wraps 65k,
+// so carry comes out clear
+#define ADDIDX2 asm __volatile__("add %A[data], %[cidx]\n\tadc %B[data], __zero_reg__\n\t" ASM_VARS);
+
+	// The same loop as showRGBInternal, for indexed color data.  Instead of adding ADV to the data pointer,
+	// the next led's palette entry is looked up while the last byte of the current led is being scaled:
+	// the index is loaded and data set to the palette start in row 3, then the index is added in rows 5, 7
+	// and 8, where carry is already clear.  The extra cycles come out of the D3 padding, which is long
+	// enough for WS2811, WS2812 and SK6812 at 16Mhz - the bit timing is the same as showRGBInternal's.
+	// Where it isn't (8Mhz, LPD1886), bits 10, 12, 14 and 15 of each led run 1-3 cycles long in the
+	// low phase.  extras/test/clockless_trinket_test.py checks both against a model of the port writes.
+	// The last led still loads index[len], one byte past the array that is never used - a plain sram
+	// read, cheaper than a branch in the middle of the bit timing.
+	static void showIndexedInternal(PixelController<RGB_ORDER> & pixels)  {
+		uint8_t *data = (uint8_t*)pixels.mData;
+		const uint8_t *index = pixels.mIndex + 1;
+		const CRGB *pal = pixels.mPalette;
+		uint8_t cidx = 0;
+		data_ptr_t port = FastPin<DATA_PIN>::port();
+		data_t mask = FastPin<DATA_PIN>::mask();
+		uint8_t scale_base = 0;
+
+		data_t hi = *port | mask;
+		data_t lo = *port & ~mask;
+		*port = lo;
+
+		// the byte currently being written out
+		uint8_t b0 = 0;
+		// the byte currently being worked on to write the next out
+		uint8_t b1 = 0;
+
+		// Setup the pixel controller
+		pixels.preStepFirstByteDithering();
+
+		// pull the dithering/adjustment values out of the pixels object for direct asm access
+		uint8_t advanceBy = pixels.advanceBy();
+		uint16_t count = pixels.mLen;
+
+		uint8_t s0 = pixels.mScale.raw[RO(0)];
+		uint8_t s1 = pixels.mScale.raw[RO(1)];
+		uint8_t s2 = pixels.mScale.raw[RO(2)];
+#if (FASTLED_SCALE8_FIXED==1)
+		s0++; s1++; s2++;
+#endif
+		uint8_t d0 = pixels.d[RO(0)];
+		uint8_t d1 = pixels.d[RO(1)];
+		uint8_t d2 = pixels.d[RO(2)];
+		uint8_t e0 = pixels.e[RO(0)];
+		uint8_t e1 = pixels.e[RO(1)];
+		uint8_t e2 = pixels.e[RO(2)];
+
+		uint8_t loopvar=0;
+
+		// This has to be done in asm to keep gcc from messing up the asm code further down
+		b0 = data[RO(0)];
+		{
+			LDSCL4(b0,O0) 	PRESCALEA2(d0)
+			PRESCALEB4(d0)	SCALE02(b0,0)
+			RORSC04(b0,1) 	ROR1(b0) CLC1
+			SCROR04(b0,2)		SCALE02(b0,3)
+			RORSC04(b0,4) 	ROR1(b0) CLC1
+			SCROR04(b0,5) 	SCALE02(b0,6)
+			RORSC04(b0,7) 	ROR1(b0) CLC1
+			MOV_ADDDE04(b1,b0,d0,e0)
+			MOV1(b0,b1)
+		}
+
+		{
+			// while(--count)
+			{
+				// Loop beginning
+				DNOP;
+				LOOP;
+
+				HI1 D1(1) QLO2(b0, 7) LDSCL4(b1,O1) 	D2(4)	LO1	PRESCALEA2(d1)	D3(2)
+				HI1	D1(1) QLO2(b0, 6) PRESCALEB4(d1)	D2(4)	LO1	SCALE12(b1,0)	D3(2)
+				HI1 D1(1) QLO2(b0, 5) RORSC14(b1,1) 	D2(4)	LO1 RORCLC2(b1)		D3(2)
+				HI1 D1(1) QLO2(b0, 4) SCROR14(b1,2)		D2(4)	LO1 SCALE12(b1,3)	D3(2)
+				HI1 D1(1) QLO2(b0, 3) RORSC14(b1,4) 	D2(4)	LO1 RORCLC2(b1) 	D3(2)
+				HI1 D1(1) QLO2(b0, 2) SCROR14(b1,5) 	D2(4)	LO1 SCALE12(b1,6)	D3(2)
+				HI1 D1(1) QLO2(b0, 1) RORSC14(b1,7) 	D2(4)	LO1 RORCLC2(b1) 	D3(2)
+				HI1 D1(1) QLO2(b0, 0)
+				switch(XTRA0) {
+					case 4: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 3: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 2: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 1: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+				}
+				MOV_ADDDE14(b0,b1,d1,e1) D2(4) LO1 D3(0)
+
+				// data = pal + 3 * index, spread over the rows with free cycles
+				HI1 D1(1) QLO2(b0, 7) LDSCL4(b1,O2) 	D2(4)	LO1	PRESCALEA2(d2)	D3(2)
+				HI1	D1(1) QLO2(b0, 6) PSBCLC4(d2)		D2(4)	LO1	SCALE22(b1,0)	D3(2)
+				HI1 D1(1) QLO2(b0, 5) RORSC24(b1,1) 	D2(4)	LO1 RORCLC2(b1) LDIDX3 	D3(5)
+				HI1 D1(1) QLO2(b0, 4) SCROR24(b1,2)		D2(4)	LO1 SCALE22(b1,3)	D3(2)
+				HI1 D1(1) QLO2(b0, 3) RORSC24(b1,4) 	D2(4)	LO1 RORCLC2(b1) ADDIDX2 	D3(4)
+				HI1 D1(1) QLO2(b0, 2) SCROR24(b1,5) 	D2(4)	LO1 SCALE22(b1,6)	D3(2)
+				HI1 D1(1) QLO2(b0, 1) RORSC24(b1,7) 	D2(4)	LO1 RORCLC2(b1) ADDIDX2 	D3(4)
+				HI1 D1(1) QLO2(b0, 0)
+				switch(XTRA0) {
+					case 4: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 3: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 2: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 1: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+				}
+
+				MOV_NEGD24(b0,b1,d2) D2(4) LO1 ADDDE1(d2,e2) ADDIDX2 D3(3)
+				HI1 D1(1) QLO2(b0, 7) LDSCL4(b1,O0) 	D2(4)	LO1	PRESCALEA2(d0)	D3(2)
+				HI1	D1(1) QLO2(b0, 6) PRESCALEB4(d0)	D2(4)	LO1	SCALE02(b1,0)	D3(2)
+				HI1 D1(1) QLO2(b0, 5) RORSC04(b1,1) 	D2(4)	LO1 RORCLC2(b1) 	D3(2)
+				HI1 D1(1) QLO2(b0, 4) SCROR04(b1,2)		D2(4)	LO1 SCALE02(b1,3)	D3(2)
+				HI1 D1(1) QLO2(b0, 3) RORSC04(b1,4) 	D2(4)	LO1 RORCLC2(b1)  	D3(2)
+				HI1 D1(1) QLO2(b0, 2) SCROR04(b1,5) 	D2(4)	LO1 SCALE02(b1,6)	D3(2)
+				HI1 D1(1) QLO2(b0, 1) RORSC04(b1,7) 	D2(4)	LO1 RORCLC2(b1) 	D3(2)
+				HI1 D1(1) QLO2(b0, 0)
+				switch(XTRA0) {
+					case 4: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 3: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 2: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+					case 1: D2(0) LO1 D3(0) HI1 D1(1) QLO2(b0,0)
+				}
+				MOV_ADDDE04(b0,b1,d0,e0) D2(4) LO1 D3(5)
+				ENDLOOP5
+			}
+			DONE;
+		}
+
+		#if (FASTLED_ALLOW_INTERRUPTS == 1)
+		// stop using the clock juggler
+		TCCR0A &= ~0x30;
+		#endif
+	}
+
+#undef ASM_VARS_INDEXED_W
+#undef ASM_VARS_INDEXED_R
+#undef ASM_VARS_COUNT
+#define ASM_VARS_INDEXED_W
+#define ASM_VARS_INDEXED_R
+#define ASM_VARS_COUNT "+x"
+#endif
+
 };
 
 #endif
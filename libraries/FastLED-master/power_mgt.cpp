@@ -76,6 +76,32 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
     return total;
 }
 
+uint32_t calculate_unscaled_power_mW_indexed( const uint8_t* index, const CRGB* palette, uint16_t numLeds )
+{
+    uint32_t red32 = 0, green32 = 0, blue32 = 0;
+    uint16_t count = numLeds;
+
+    while( count) {
+        const CRGB & c = palette[*index++];
+        red32   += c.r;
+        green32 += c.g;
+        blue32  += c.b;
+        count--;
+    }
+
+    red32   *= gRed_mW;
+    green32 *= gGreen_mW;
+    blue32  *= gBlue_mW;
+
+    red32   >>= 8;
+    green32 >>= 8;
+    blue32  >>= 8;
+
+    uint32_t total = red32 + green32 + blue32 + (gDark_mW * numLeds);
+
+    return total;
+}
+
 
 uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_V, uint32_t max_power_mA) {
 	return calculate_max_brightness_for_power_mW(ledbuffer, numLeds, target_brightness, max_power_V * max_power_mA);
@@ -103,7 +129,11 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 
     CLEDController *pCur = CLEDController::head();
 	while(pCur) {
-        total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        if( pCur->palette()) {
+            total_mW += calculate_unscaled_power_mW_indexed( pCur->ledIndex(), pCur->palette(), pCur->size());
+        } else {
+            total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        }
 		pCur = pCur->next();
 	}
 
@@ -58,6 +58,11 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 ///
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 
+/// calculate_unscaled_power_mW_indexed does the same for indexed
+///   LED data, see CLEDController::setLedsIndexed
+///
+uint32_t calculate_unscaled_power_mW_indexed( const uint8_t* index, const CRGB* palette, uint16_t numLeds);
+
 /// calculate_max_brightness_for_power_mW tells you the highest brightness
 ///   level you can use and still stay under the specified power budget for 
 ///   a given set of leds.  It takes a pointer to an array of CRGB objects, a
@@ -0,0 +1,213 @@
+#ifndef GyverButtonBank_h
+#define GyverButtonBank_h
+#include <Arduino.h>
+#include "GyverButton.h"
+
+/*
+	GButtonBank<N> - банк из N кнопок (до 16) на одном-двух портах. Возможности:
+	- Порт читается целиком за одно обращение к регистру PINx (кнопка i - бит i порта)
+	- Антидребезг всех кнопок параллельно, вертикальными 2-битными счётчиками (4 одинаковых опроса подряд)
+	- Один вызов millis() на весь банк за тик
+	- Те же события, что у GButton: нажатие, отпускание, клик, удержание, шаги, количество кликов
+	- 4 байта состояния на кнопку вместо ~20 байт у GButton
+	- Возможность подавать состояние всех кнопок напрямую (сдвиговые регистры, матричные клавиатуры)
+
+	Пример: 8 кнопок на D0..D7 (PIN --- КНОПКА --- GND)
+	GButtonBank<8> bank(&PIND);
+	bank.tick();
+	if (bank.isClick(3)) ...
+*/
+
+template <bool wide> struct GButtonBankMask { typedef uint8_t type; };
+template <> struct GButtonBankMask<true> { typedef uint16_t type; };
+
+template <uint8_t N>
+class GButtonBank
+{
+	static_assert(N > 0 && N <= 16, "GButtonBank supports 1..16 buttons");
+	typedef typename GButtonBankMask<(N > 8)>::type mask_t;
+
+  public:
+	// банк кнопок, принимает адреса регистров PINx (для N > 8 - второй порт под кнопки 8..15)
+	// и маску используемых битов (неиспользуемые биты считаются отпущенными)
+	GButtonBank(volatile uint8_t *pinReg, volatile uint8_t *pinRegHigh = NULL, mask_t mask = (mask_t)((1UL << N) - 1)) {
+		_pinReg = pinReg;
+		_pinRegHigh = pinRegHigh;
+		_mask = mask & (mask_t)((1UL << N) - 1);
+		init();
+		setType(HIGH_PULL);
+	}
+	// банк без портов, состояние подаётся через tick(raw)
+	GButtonBank() {
+		_pinReg = NULL;
+		_pinRegHigh = NULL;
+		_mask = (mask_t)((1UL << N) - 1);
+		init();
+	}
+
+	void setDebounce(uint16_t debounce) {				// время антидребезга (по умолчанию 80 мс), опрос идёт с шагом debounce / 4
+		_sample_step = debounce >> 2;
+		if (_sample_step == 0) _sample_step = 1;
+	}
+	void setTimeout(uint16_t timeout) { _timeout = timeout; }					// таймаут удержания (по умолчанию 500 мс)
+	void setStepTimeout(uint16_t step_timeout) { _step_timeout = step_timeout; }	// таймаут между инкрементами (по умолчанию 400 мс)
+	void setDirection(boolean dir) { _inv_state = dir; }						// NORM_OPEN / NORM_CLOSE для всех кнопок банка
+
+	void setType(boolean type) {						// HIGH_PULL / LOW_PULL для всех кнопок банка
+		_type = type;
+#if defined(__AVR__)
+		// на AVR регистры PINx, DDRx, PORTx идут подряд
+		if (_pinReg) setPortType(_pinReg, (uint8_t)_mask, type);
+		if (_pinRegHigh) setPortType(_pinRegHigh, (uint8_t)(_mask >> 8), type);
+#endif
+	}
+
+	// опрос банка: читает порты, сам следит за периодом антидребезга
+	void tick() {
+		mask_t raw = 0;
+		if (_pinReg) raw = *_pinReg;
+		if (N > 8 && _pinRegHigh) raw |= (mask_t)((uint16_t)*_pinRegHigh << 8);
+		// приводим к виду 1 - нажата
+		if (!(_inv_state ^ _type)) raw = ~raw;
+		tickRaw(raw);
+	}
+
+	// опрос внешнего значения, бит i = 1 - кнопка i нажата
+	void tick(mask_t state) {
+		if (_inv_state) state = ~state;
+		tickRaw(state);
+	}
+
+	boolean isPress(uint8_t i) { return takeFlag(_isPress_f, i); }		// true при нажатии. Сбрасывается после вызова
+	boolean isRelease(uint8_t i) { return takeFlag(_isRelease_f, i); }	// true при отпускании. Сбрасывается после вызова
+	boolean isClick(uint8_t i) { return takeFlag(_isOne_f, i); }		// true при клике. Сбрасывается после вызова
+	boolean isHolded(uint8_t i) { return takeFlag(_isHolded_f, i); }	// true при удержании дольше timeout. Сбрасывается после вызова
+	boolean isHold(uint8_t i) { return (_step_flag >> i) & 1; }			// true при удержании, не сбрасывается
+	boolean state(uint8_t i) { return (_btn_state >> i) & 1; }			// состояние кнопки после антидребезга
+
+	boolean isSingle(uint8_t i) { return takeClicks(i, 1); }			// одиночный клик. Сбрасывается после вызова
+	boolean isDouble(uint8_t i) { return takeClicks(i, 2); }			// двойной клик. Сбрасывается после вызова
+	boolean isTriple(uint8_t i) { return takeClicks(i, 3); }			// тройной клик. Сбрасывается после вызова
+	boolean hasClicks(uint8_t i) { return takeFlag(_counter_flag, i); }	// проверка на наличие кликов. Сбрасывается после вызова
+	uint8_t getClicks(uint8_t i) { return _last_counter[i]; }			// вернуть количество кликов
+
+	boolean isStep(uint8_t i) {							// true по таймеру setStepTimeout при удержании
+		uint16_t now = millis();
+		if (((_step_flag >> i) & 1) && (uint16_t)(now - _btn_timer[i]) >= _step_timeout) {
+			_btn_timer[i] = now;
+			return true;
+		}
+		return false;
+	}
+
+	mask_t states() { return _btn_state; }				// состояния всех кнопок одной маской
+
+  private:
+	void init() {
+		_sample_step = 80 >> 2;
+		_timeout = 500;
+		_step_timeout = 400;
+		_inv_state = NORM_OPEN;
+		_type = HIGH_PULL;
+		_sample_timer = 0;
+		_btn_state = _cnt0 = _cnt1 = 0;
+		_isPress_f = _isRelease_f = _isOne_f = _isHolded_f = 0;
+		_oneClick_f = _hold_flag = _step_flag = _counter_flag = _counting = 0;
+		for (uint8_t i = 0; i < N; i++) _btn_timer[i] = _btn_counter[i] = _last_counter[i] = 0;
+	}
+
+#if defined(__AVR__)
+	static void setPortType(volatile uint8_t *pinReg, uint8_t bits, boolean type) {
+		*(pinReg + 1) &= ~bits;						// DDRx - вход
+		if (type) *(pinReg + 2) &= ~bits;			// PORTx - без подтяжки
+		else *(pinReg + 2) |= bits;					// PORTx - INPUT_PULLUP
+	}
+#endif
+
+	boolean takeFlag(mask_t &flags, uint8_t i) {
+		mask_t bit = (mask_t)1 << i;
+		if (flags & bit) {
+			flags &= ~bit;
+			return true;
+		}
+		return false;
+	}
+	boolean takeClicks(uint8_t i, uint8_t clicks) {
+		if (((_counter_flag >> i) & 1) && _last_counter[i] == clicks) {
+			_counter_flag &= ~((mask_t)1 << i);
+			return true;
+		}
+		return false;
+	}
+
+	void tickRaw(mask_t raw) {
+		uint16_t now = millis();
+		if ((uint16_t)(now - _sample_timer) < _sample_step) return;
+		_sample_timer = now;
+		raw &= _mask;
+
+		// вертикальный счётчик: бит меняет состояние после 4 опросов подряд с новым значением
+		mask_t delta = raw ^ _btn_state;
+		_cnt1 = (_cnt1 ^ _cnt0) & delta;
+		_cnt0 = ~_cnt0 & delta;
+		mask_t toggle = delta & ~(_cnt0 | _cnt1);
+		_btn_state ^= toggle;
+
+		mask_t pressed = toggle & _btn_state;
+		mask_t released = toggle & ~_btn_state;
+
+		_isPress_f |= pressed;
+		_oneClick_f |= pressed;
+
+		_isRelease_f |= released;
+		_hold_flag &= ~released;
+		_step_flag &= ~released;
+		_isOne_f |= released & _oneClick_f;
+		_oneClick_f &= ~released;
+
+		// по кнопкам идём только там, где что-то происходит: нажатие/отпускание,
+		// нажатая кнопка (ждём удержание) или незакрытая серия кликов
+		mask_t active = toggle | (_btn_state & ~_hold_flag) | _counting;
+		for (uint8_t i = 0; active; i++, active >>= 1) {
+			if (!(active & 1)) continue;
+			mask_t bit = (mask_t)1 << i;
+			if (pressed & bit) {
+				_btn_counter[i]++;
+				_counting |= bit;
+				_btn_timer[i] = now;
+			}
+			if (released & bit) _btn_timer[i] = now;
+			uint16_t elapsed = now - _btn_timer[i];
+			if ((_btn_state & bit) && !(_hold_flag & bit) && elapsed >= _timeout) {
+				_hold_flag |= bit;
+				_isHolded_f |= bit;
+				_step_flag |= bit;
+				_oneClick_f &= ~bit;
+				_btn_counter[i] = 0;
+				_counting &= ~bit;
+				_btn_timer[i] = now;
+				elapsed = 0;
+			}
+			if ((_counting & bit) && elapsed >= _timeout) {
+				_last_counter[i] = _btn_counter[i];
+				_btn_counter[i] = 0;
+				_counting &= ~bit;
+				_counter_flag |= bit;
+			}
+		}
+	}
+
+	volatile uint8_t *_pinReg;
+	volatile uint8_t *_pinRegHigh;
+	mask_t _mask;
+	uint16_t _sample_step, _timeout, _step_timeout, _sample_timer;
+	boolean _inv_state, _type;
+
+	mask_t _btn_state, _cnt0, _cnt1;					// состояние после антидребезга и вертикальный счётчик
+	mask_t _isPress_f, _isRelease_f, _isOne_f, _isHolded_f, _counter_flag;
+	mask_t _oneClick_f, _hold_flag, _step_flag, _counting;
+	uint16_t _btn_timer[N];
+	uint8_t _btn_counter[N], _last_counter[N];
+};
+
+#endif
@@ -0,0 +1,32 @@
+/*
+   Пример использования GButtonBank - 8 кнопок на одном порту
+   Весь порт читается за одно обращение, антидребезг всех кнопок параллельно
+   Кнопки на D4..D7 (PIN --- КНОПКА --- GND), биты 0..3 порта D не трогаем (Serial и прерывания)
+*/
+
+#include "GyverButtonBank.h"
+GButtonBank<8> bank(&PIND, NULL, 0b11110000);  // порт D, маска используемых битов
+int value = 0;
+
+void setup() {
+  Serial.begin(9600);
+  bank.setTimeout(500);
+}
+
+void loop() {
+  bank.tick();  // обязательная функция отработки. Должна постоянно опрашиваться
+
+  for (byte i = 4; i < 8; i++) {
+    if (bank.isSingle(i)) {
+      Serial.print("Button ");
+      Serial.println(i);
+    }
+    if (bank.isDouble(i)) {
+      Serial.print("Double ");
+      Serial.println(i);
+    }
+  }
+
+  if (bank.isStep(4)) Serial.println(++value);   // удержание D4 - инкремент с шагом по времени
+  if (bank.isStep(5)) Serial.println(--value);   // удержание D5 - декремент
+}
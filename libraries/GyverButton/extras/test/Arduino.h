@@ -0,0 +1,13 @@
+// заглушка Arduino.h для проверки GButtonBank на компьютере: время задаёт тест
+#ifndef Arduino_h
+#define Arduino_h
+#include <stdint.h>
+#include <stddef.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+extern unsigned long test_millis;
+inline unsigned long millis() { return test_millis; }
+
+#endif
@@ -0,0 +1,150 @@
+/*
+	Проверка GButtonBank на компьютере, без платы: millis() подменён (Arduino.h в этой папке),
+	на вход банка подаются записанные трассы дребезга, проверяются переходы вертикального счётчика
+	и события нажатия, отпускания, клика и удержания.
+	Сборка и запуск из этой папки:
+	g++ -std=gnu++11 -Wall -I. -I../.. bank_test.cpp -o bank_test && ./bank_test
+*/
+#include <stdio.h>
+#include "GyverButtonBank.h"
+
+unsigned long test_millis;
+static int fails;
+
+#define CHECK(x) do { if (!(x)) { printf("%s:%d: %s (t = %lu)\n", __FILE__, __LINE__, #x, test_millis); fails++; } } while (0)
+
+// трасса: моменты переключения входа, мс от начала, первый фронт - нажатие
+struct Trace {
+	const uint16_t *edges;
+	uint8_t count;
+	bool level(unsigned long t) const {		// true - нажата
+		bool pressed = false;
+		for (uint8_t i = 0; i < count && edges[i] <= t; i++) pressed = !pressed;
+		return pressed;
+	}
+};
+
+// гоняет банк с шагом 1 мс до момента end, кнопка bit получает трассу, остальные - rest
+template <uint8_t N, typename M>
+void replay(GButtonBank<N> &bank, unsigned long start, unsigned long end, uint8_t bit, const Trace &tr, M rest = 0) {
+	for (; test_millis < end; test_millis++) {
+		M raw = rest;
+		if (tr.level(test_millis - start)) raw |= (M)1 << bit;
+		bank.tick(raw);
+	}
+}
+
+// нажатие с дребезгом, второй опрос (20 мс) попадает в отскок; отпускание с дребезгом через 200 мс
+const uint16_t click_edges[] = {0, 3, 5, 6, 9, 19, 23, 200, 202, 204, 207, 208};
+// короткие помехи: импульсы по 1-15 мс, каждый короче 4 опросов по 20 мс
+const uint16_t glitch_edges[] = {10, 11, 40, 55, 90, 92, 130, 140};
+// удержание 1200 мс с дребезгом на нажатии
+const uint16_t hold_edges[] = {0, 2, 4, 1200};
+// двойной клик
+const uint16_t double_edges[] = {0, 150, 300, 450};
+
+void testDebounce() {
+	GButtonBank<8> bank;
+	test_millis = 1000;
+	Trace tr = {click_edges, sizeof(click_edges) / sizeof(click_edges[0])};
+	unsigned long t0 = test_millis;
+
+	// состояние меняется только на 4-м одинаковом опросе подряд (опрос раз в 20 мс):
+	// отскок на 20 мс сбрасывает счётчик, нажатие засчитано на опросах 40, 60, 80, 100
+	replay<8, uint8_t>(bank, t0, t0 + 100, 2, tr);
+	CHECK(!bank.state(2));
+	CHECK(!bank.isPress(2));
+	replay<8, uint8_t>(bank, t0, t0 + 101, 2, tr);
+	CHECK(bank.state(2));
+	CHECK(bank.isPress(2));
+	CHECK(!bank.isPress(2));				// флаг сбрасывается после чтения
+	CHECK(!bank.isRelease(2));
+	CHECK(bank.states() == (1 << 2));		// соседние биты не задеты
+
+	// отпускание: событие одно, клик засчитан, серия закрывается через timeout
+	replay<8, uint8_t>(bank, t0, t0 + 300, 2, tr);
+	CHECK(!bank.state(2));
+	CHECK(bank.isRelease(2));
+	CHECK(!bank.isRelease(2));
+	CHECK(bank.isClick(2));
+	CHECK(!bank.isPress(2));
+	CHECK(!bank.hasClicks(2));				// серия ещё открыта
+	replay<8, uint8_t>(bank, t0, t0 + 900, 2, tr);
+	CHECK(bank.getClicks(2) == 1);
+	CHECK(bank.isSingle(2));
+	CHECK(!bank.isHolded(2));
+}
+
+void testGlitches() {
+	GButtonBank<8> bank;
+	test_millis = 5000;
+	Trace tr = {glitch_edges, sizeof(glitch_edges) / sizeof(glitch_edges[0])};
+	replay<8, uint8_t>(bank, test_millis, test_millis + 400, 5, tr);
+	CHECK(!bank.state(5));
+	CHECK(!bank.isPress(5));
+	CHECK(!bank.isRelease(5));
+	CHECK(!bank.hasClicks(5));
+}
+
+void testHold() {
+	GButtonBank<8> bank;
+	test_millis = 9000;
+	Trace tr = {hold_edges, sizeof(hold_edges) / sizeof(hold_edges[0])};
+	unsigned long t0 = test_millis;
+	// нажатие засчитано на 4-м опросе (~80 мс), удержание - через timeout (500 мс) после него
+	replay<8, uint8_t>(bank, t0, t0 + 560, 0, tr);
+	CHECK(bank.isPress(0));
+	CHECK(!bank.isHolded(0));
+	CHECK(!bank.isHold(0));
+	replay<8, uint8_t>(bank, t0, t0 + 620, 0, tr);
+	CHECK(bank.isHolded(0));
+	CHECK(!bank.isHolded(0));
+	CHECK(bank.isHold(0));
+	CHECK(!bank.isStep(0));
+	replay<8, uint8_t>(bank, t0, t0 + 1060, 0, tr);
+	CHECK(bank.isStep(0));					// шаг через step timeout (400 мс)
+	CHECK(!bank.isStep(0));
+	// после удержания отпускание не даёт клика и серии
+	replay<8, uint8_t>(bank, t0, t0 + 2000, 0, tr);
+	CHECK(bank.isRelease(0));
+	CHECK(!bank.isHold(0));
+	CHECK(!bank.isClick(0));
+	CHECK(!bank.hasClicks(0));
+}
+
+void testDoubleWide() {
+	// 16 кнопок: кнопка 12 делает двойной клик, пока 3 и 15 зажаты
+	GButtonBank<16> bank;
+	test_millis = 65000;					// таймеры банка 16-битные, прогон переходит через 65535
+	Trace tr = {double_edges, sizeof(double_edges) / sizeof(double_edges[0])};
+	unsigned long t0 = test_millis;
+	replay<16, uint16_t>(bank, t0, t0 + 1200, 12, tr, (1 << 3) | (1 << 15));
+	CHECK(bank.state(3) && bank.state(15) && !bank.state(12));
+	CHECK(bank.isDouble(12));
+	CHECK(!bank.isSingle(12));
+	CHECK(bank.isHolded(3) && bank.isHolded(15));
+	CHECK(!bank.hasClicks(3));
+}
+
+void testPort() {
+	// порт с подтяжкой: нажатая кнопка читается как 0, неиспользуемые биты по маске не участвуют
+	volatile uint8_t pin = 0xFF;
+	GButtonBank<4> bank(&pin, NULL, 0x05);
+	test_millis = 20000;
+	pin = 0xF0;								// все 4 кнопки прижаты к GND
+	for (uint8_t i = 0; i < 100; i++, test_millis++) bank.tick();
+	CHECK(bank.states() == 0x05);
+	CHECK(bank.isPress(0) && bank.isPress(2));
+	CHECK(!bank.isPress(1) && !bank.isPress(3));
+}
+
+int main() {
+	testDebounce();
+	testGlitches();
+	testHold();
+	testDoubleWide();
+	testPort();
+	if (fails) printf("%d checks failed\n", fails);
+	else printf("ok\n");
+	return fails ? 1 : 0;
+}
@@ -114,15 +114,31 @@ int  MATCH_SPACE (int measured_ticks,  int desired_us)
 //+=============================================================================
 // Interrupt Service Routine - Fires every 50uS
 // TIMER2 interrupt code to collect raw data.
-// Widths of alternating SPACE, MARK are recorded in rawbuf.
+// Widths of alternating SPACE, MARK are recorded in the rawbuf of the head slot.
 // Recorded in ticks of 50uS [microseconds, 0.000050 seconds]
 // 'rawlen' counts the number of entries recorded so far.
 // First entry is the SPACE between transmissions.
 // As soon as a the first [SPACE] entry gets long:
-//   Ready is set; State switches to IDLE; Timing of SPACE continues.
+//   The slot is handed to decode(); Recording moves on to the next free slot;
+//   State switches to IDLE (or STOP if the ring is full); Timing of SPACE continues.
 // As soon as first MARK arrives:
-//   Gap width is recorded; Ready is cleared; New logging starts
+//   Gap width is recorded; New logging starts
 //
+static inline void  captureDone ( )
+{
+	irparams.ready++;
+	if (++irparams.head >= RAWSLOTS)  irparams.head = 0 ;
+	if (irparams.ready < RAWSLOTS) {
+		// Claim the next slot; it may still hold an old, already decoded capture
+		irparams.slots[irparams.head].rawlen   = 0;
+		irparams.slots[irparams.head].overflow = false;
+		irparams.rcvstate = STATE_IDLE;
+	} else {
+		irparams.rcvstate = STATE_STOP;  // head is the slot decode() is holding; resume() frees it
+	}
+}
+
+#ifndef IR_USE_EDGE
 ISR (TIMER_INTR_NAME)
 {
 	TIMER_RESET;
@@ -130,9 +146,11 @@ ISR (TIMER_INTR_NAME)
 	// Read if IR Receiver -> SPACE [xmt LED off] or a MARK [xmt LED on]
 	// digitalRead() is very slow. Optimisation is possible, but makes the code unportable
 	uint8_t  irdata = (uint8_t)digitalRead(irparams.recvpin);
+	volatile irslot_t  *slot = &irparams.slots[irparams.head];
 
 	irparams.timer++;  // One more 50uS tick
-	if (irparams.rawlen >= RAWBUF)  irparams.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
+	if (((irparams.rcvstate == STATE_MARK) || (irparams.rcvstate == STATE_SPACE)) && (slot->rawlen >= RAWBUF))
+		irparams.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
 
 	switch(irparams.rcvstate) {
 		//......................................................................
@@ -143,9 +161,10 @@ ISR (TIMER_INTR_NAME)
 
 				} else {
 					// Gap just ended; Record duration; Start recording transmission
-					irparams.overflow                  = false;
-					irparams.rawlen                    = 0;
-					irparams.rawbuf[irparams.rawlen++] = irparams.timer;
+					slot->overflow                     = false;
+					slot->gap                          = irparams.timer;
+					slot->rawlen                       = 0;
+					slot->rawbuf[slot->rawlen++]       = RAWTICKS(irparams.timer);
 					irparams.timer                     = 0;
 					irparams.rcvstate                  = STATE_MARK;
 				}
@@ -154,7 +173,7 @@ ISR (TIMER_INTR_NAME)
 		//......................................................................
 		case STATE_MARK:  // Timing Mark
 			if (irdata == SPACE) {   // Mark ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
+				slot->rawbuf[slot->rawlen++]       = RAWTICKS(irparams.timer);
 				irparams.timer                     = 0;
 				irparams.rcvstate                  = STATE_SPACE;
 			}
@@ -162,26 +181,26 @@ ISR (TIMER_INTR_NAME)
 		//......................................................................
 		case STATE_SPACE:  // Timing Space
 			if (irdata == MARK) {  // Space just ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
+				slot->rawbuf[slot->rawlen++]       = RAWTICKS(irparams.timer);
 				irparams.timer                     = 0;
 				irparams.rcvstate                  = STATE_MARK;
 
 			} else if (irparams.timer > GAP_TICKS) {  // Space
 					// A long Space, indicates gap between codes
 					// Flag the current code as ready for processing
-					// Switch to STOP
+					// Move on to the next slot
 					// Don't reset timer; keep counting Space width
-					irparams.rcvstate = STATE_STOP;
+					captureDone();
 			}
 			break;
 		//......................................................................
-		case STATE_STOP:  // Waiting; Measuring Gap
+		case STATE_STOP:  // Ring full; Measuring Gap
 		 	if (irdata == MARK)  irparams.timer = 0 ;  // Reset gap timer
 		 	break;
 		//......................................................................
-		case STATE_OVERFLOW:  // Flag up a read overflow; Stop the State Machine
-			irparams.overflow = true;
-			irparams.rcvstate = STATE_STOP;
+		case STATE_OVERFLOW:  // Flag up a read overflow; Hand the slot over
+			slot->overflow = true;
+			captureDone();
 		 	break;
 	}
 
@@ -196,3 +215,65 @@ ISR (TIMER_INTR_NAME)
 	}
 #endif // BLINKLED
 }
+
+#else // IR_USE_EDGE
+//+=============================================================================
+// Pin change interrupt - fires on every edge of the IR detector output
+// Same state machine and ring as the timer ISR, but the width of each MARK
+// and SPACE is the micros() difference between two edges, rounded to 50uS ticks.
+// The end of a transmission has no edge; irEdgeTimeout() closes it from
+// decode()/isIdle() once the line has been quiet for _GAP uS.
+//
+static unsigned long  lastEdge;
+
+void  irEdgeInit ( )
+{
+	lastEdge = micros();
+}
+
+void  irEdgeTimeout ( )
+{
+	noInterrupts();
+	if ((irparams.rcvstate == STATE_SPACE) && (micros() - lastEdge > _GAP))  captureDone() ;
+	interrupts();
+}
+
+void  irEdge ( )
+{
+	unsigned long  now   = micros();
+	unsigned long  width = now - lastEdge;
+	unsigned int   ticks = (width >= 0xFFFFUL * USECPERTICK) ? 0xFFFF : (width + USECPERTICK / 2) / USECPERTICK;
+	lastEdge = now;
+
+	volatile irslot_t  *slot = &irparams.slots[irparams.head];
+
+	// A space longer than a gap means the previous transmission ended unnoticed
+	if ((irparams.rcvstate == STATE_SPACE) && (ticks > GAP_TICKS))  captureDone() ;
+
+	switch(irparams.rcvstate) {
+		case STATE_IDLE:  // Only a MARK after a long enough gap starts a transmission
+			if ((ticks >= GAP_TICKS) && ((uint8_t)digitalRead(irparams.recvpin) == MARK)) {
+				slot = &irparams.slots[irparams.head];
+				slot->overflow               = false;
+				slot->gap                    = ticks;
+				slot->rawlen                 = 0;
+				slot->rawbuf[slot->rawlen++] = RAWTICKS(ticks);
+				irparams.rcvstate            = STATE_MARK;
+			}
+			break;
+
+		case STATE_MARK:  // Mark ended
+		case STATE_SPACE: // Space ended
+			slot->rawbuf[slot->rawlen++] = RAWTICKS(ticks);
+			irparams.rcvstate = (irparams.rcvstate == STATE_MARK) ? STATE_SPACE : STATE_MARK;
+			if (slot->rawlen >= RAWBUF) {
+				slot->overflow = true;
+				captureDone();
+			}
+			break;
+
+		case STATE_STOP:  // Ring full; edges only move lastEdge
+			break;
+	}
+}
+#endif // IR_USE_EDGE
@@ -79,6 +79,12 @@
 #define DECODE_LEGO_PF       0 // NOT WRITTEN
 #define SEND_LEGO_PF         1
 
+//------------------------------------------------------------------------------
+// decode() looks at the first mark once and only runs the decoders whose
+// header can match it. Set to 0 to try every enabled decoder in turn.
+//
+#define DECODE_CLASSIFY      1
+
 //------------------------------------------------------------------------------
 // When sending a Pronto code we request to send either the "once" code
 //                                                   or the "repeat" code
@@ -155,9 +161,10 @@ class decode_results
 		unsigned int           address;      // Used by Panasonic & Sharp [16-bits]
 		unsigned long          value;        // Decoded value [max 32-bits]
 		int                    bits;         // Number of bits in decoded value
-		volatile unsigned int  *rawbuf;      // Raw intervals in 50uS ticks
+		volatile uint8_t       *rawbuf;      // Raw intervals in 50uS ticks (saturated at 255)
 		int                    rawlen;       // Number of records in rawbuf
 		int                    overflow;     // true iff IR raw code too long
+		unsigned int           gap;          // Leading gap in 50uS ticks (rawbuf[0] saturates)
 };
 
 //------------------------------------------------------------------------------
@@ -41,6 +41,22 @@
 // Information for the Interrupt Service Routine
 //
 #define RAWBUF  101  // Maximum length of raw duration buffer
+#ifndef RAWSLOTS
+#	define RAWSLOTS  3  // Captures the ISR can hold before decode() catches up
+#endif
+
+// Durations are stored as 8-bit ticks, saturated at 255 (12.75ms).
+// Only the leading gap ever gets that long, so it is also kept in full in 'gap'.
+#define RAWTICKS(t)  ((uint8_t)((t) > 255 ? 255 : (t)))
+
+typedef
+	struct {
+		unsigned int  gap;             // leading gap, 50uS ticks, not saturated
+		uint8_t       rawlen;          // counter of entries in rawbuf
+		uint8_t       overflow;        // Raw buffer overflow occurred
+		uint8_t       rawbuf[RAWBUF];  // raw data
+	}
+irslot_t;
 
 typedef
 	struct {
@@ -49,10 +65,11 @@ typedef
 		uint8_t       recvpin;         // Pin connected to IR data from detector
 		uint8_t       blinkpin;
 		uint8_t       blinkflag;       // true -> enable blinking of pin on IR processing
-		uint8_t       rawlen;          // counter of entries in rawbuf
+		uint8_t       head;            // Slot the ISR is recording into
+		uint8_t       tail;            // Oldest complete capture, next for decode()
+		uint8_t       ready;           // Number of complete captures in the ring
 		unsigned int  timer;           // State timer, counts 50uS ticks.
-		unsigned int  rawbuf[RAWBUF];  // raw data
-		uint8_t       overflow;        // Raw buffer overflow occurred
+		irslot_t      slots[RAWSLOTS]; // Ring of raw captures
 	}
 irparams_t;
 
@@ -60,7 +77,7 @@ irparams_t;
 #define STATE_IDLE      2
 #define STATE_MARK      3
 #define STATE_SPACE     4
-#define STATE_STOP      5
+#define STATE_STOP      5  // Ring is full, waiting for resume()
 #define STATE_OVERFLOW  6
 
 // Allow all parts of the code access to the ISR data
@@ -110,4 +127,13 @@ EXTERN  volatile irparams_t  irparams;
 // All board specific stuff has been moved to its own file, included here.
 #include "boarddefs.h"
 
+//------------------------------------------------------------------------------
+// Edge receiver (IR_USE_EDGE), see IRremote.cpp
+//
+#ifdef IR_USE_EDGE
+void  irEdgeInit    ( ) ;
+void  irEdgeTimeout ( ) ;
+void  irEdge        ( ) ;
+#endif
+
 #endif
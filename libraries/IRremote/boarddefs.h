@@ -33,6 +33,12 @@
 // Undefine for boards supplying their own.
 #define USE_DEFAULT_ENABLE_IR_IN
 
+// Receive on pin edges (attachInterrupt + micros()) instead of sampling the
+// pin from a 50uS timer interrupt. No CPU load while the remote is idle and
+// no timer taken for receiving. The receive pin must support attachInterrupt().
+// Sending still uses the timer selected below.
+//#define IR_USE_EDGE
+
 // Duty cycle in percent for sent signals. Presently takes effect only with USE_SOFT_CARRIER
 #define DUTY_CYCLE 50
 
@@ -96,6 +102,14 @@
 #	define BLINKLED_OFF()  (PORTB &= B11011111)
 #endif
 
+// The edge receiver brings its own enableIRIn()
+#ifdef IR_USE_EDGE
+#	ifndef USE_DEFAULT_ENABLE_IR_IN
+#		error "IR_USE_EDGE is only implemented for boards using the default enableIRIn()"
+#	endif
+#	undef USE_DEFAULT_ENABLE_IR_IN
+#endif
+
 //------------------------------------------------------------------------------
 // CPU Frequency
 //
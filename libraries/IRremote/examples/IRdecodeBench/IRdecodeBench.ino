@@ -0,0 +1,77 @@
+/*
+ * IRremote: IRdecodeBench - time decode() on canned raw captures
+ * No IR hardware needed. Each capture is copied into the receive ring and
+ * decoded a few hundred times; the average time per frame is printed.
+ *
+ * Run it once as is, then with DECODE_CLASSIFY set to 0 in IRremote.h
+ * to compare the header classifier against the sequential decoder chain.
+ */
+
+#include <IRremote.h>
+#include <IRremoteInt.h>
+
+#define RUNS 200
+
+IRrecv irrecv(11);
+decode_results results;
+
+// Raw captures in 50uS ticks, as the ISR records them (gap first, marks with excess)
+const uint8_t necFrame[] PROGMEM = {
+  255, 182, 88,
+  13, 9, 13, 9, 13, 32, 13, 9, 13, 32, 13, 9, 13, 9, 13, 32,
+  13, 32, 13, 32, 13, 9, 13, 32, 13, 9, 13, 32, 13, 32, 13, 9,
+  13, 9, 13, 32, 13, 9, 13, 9, 13, 32, 13, 9, 13, 9, 13, 9,
+  13, 32, 13, 9, 13, 32, 13, 32, 13, 9, 13, 32, 13, 32, 13, 32,
+  13
+};
+const uint8_t sonyFrame[] PROGMEM = {
+  255, 50, 10,
+  26, 10, 14, 10, 26, 10, 14, 10, 26, 10, 14, 10, 14, 10, 26, 10,
+  14, 10, 14, 10, 14, 10, 14
+};
+const uint8_t rc5Frame[] PROGMEM = {
+  255, 20, 16, 20, 16, 38, 34, 20, 16, 20, 16, 20, 16, 20, 16, 38,
+  34, 38, 16, 20, 34, 20
+};
+const uint8_t noiseFrame[] PROGMEM = {
+  255, 7, 23, 41, 5, 12, 66, 3, 19, 27, 8, 90, 14, 6, 33, 11, 4
+};
+
+void load(const uint8_t *frame, uint8_t len) {
+  volatile irslot_t *slot = &irparams.slots[irparams.tail];
+  for (uint8_t i = 0; i < len; i++) slot->rawbuf[i] = pgm_read_byte(&frame[i]);
+  slot->rawlen = len;
+  slot->gap = 0xFFFF;
+  slot->overflow = false;
+}
+
+void bench(const __FlashStringHelper *name, const uint8_t *frame, uint8_t len) {
+  unsigned long total = 0;
+  for (int i = 0; i < RUNS; i++) {
+    load(frame, len);
+    irparams.ready = 1;
+    unsigned long start = micros();
+    irrecv.decode(&results);
+    total += micros() - start;
+  }
+  Serial.print(name);
+  Serial.print(F(": type "));
+  Serial.print(results.decode_type);
+  Serial.print(F(", value 0x"));
+  Serial.print(results.value, HEX);
+  Serial.print(F(", "));
+  Serial.print((float)total / RUNS);
+  Serial.println(F(" us per frame"));
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  bench(F("NEC"), necFrame, sizeof(necFrame));
+  bench(F("Sony"), sonyFrame, sizeof(sonyFrame));
+  bench(F("RC5"), rc5Frame, sizeof(rc5Frame));
+  bench(F("Noise"), noiseFrame, sizeof(noiseFrame));
+}
+
+void loop() {
+}
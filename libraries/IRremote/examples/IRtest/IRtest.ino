@@ -84,34 +84,37 @@ public:
   // Copies the dummy buf into the interrupt buf
   void useDummyBuf() {
     int last = SPACE;
-    irparams.rcvstate = STATE_STOP;
-    irparams.rawlen = 1; // Skip the gap
+    volatile irslot_t *slot = &irparams.slots[irparams.tail];
+    irparams.ready = 1;
+    slot->overflow = false;
+    slot->gap = 0xFFFF; // Long gap, not a repeat
+    slot->rawlen = 1; // Skip the gap
     for (int i = 0 ; i < sendlogcnt; i++) {
       if (sendlog[i] < 0) {
         if (last == MARK) {
           // New space
-          irparams.rawbuf[irparams.rawlen++] = (-sendlog[i] - MARK_EXCESS) / USECPERTICK;
+          slot->rawbuf[slot->rawlen++] = RAWTICKS((-sendlog[i] - MARK_EXCESS) / USECPERTICK);
           last = SPACE;
         } 
         else {
           // More space
-          irparams.rawbuf[irparams.rawlen - 1] += -sendlog[i] / USECPERTICK;
+          slot->rawbuf[slot->rawlen - 1] = RAWTICKS(slot->rawbuf[slot->rawlen - 1] + -sendlog[i] / USECPERTICK);
         }
       } 
       else if (sendlog[i] > 0) {
         if (last == SPACE) {
           // New mark
-          irparams.rawbuf[irparams.rawlen++] = (sendlog[i] + MARK_EXCESS) / USECPERTICK;
+          slot->rawbuf[slot->rawlen++] = RAWTICKS((sendlog[i] + MARK_EXCESS) / USECPERTICK);
           last = MARK;
         } 
         else {
           // More mark
-          irparams.rawbuf[irparams.rawlen - 1] += sendlog[i] / USECPERTICK;
+          slot->rawbuf[slot->rawlen - 1] = RAWTICKS(slot->rawbuf[slot->rawlen - 1] + sendlog[i] / USECPERTICK);
         }
       }
     }
-    if (irparams.rawlen % 2) {
-      irparams.rawlen--; // Remove trailing space
+    if (slot->rawlen % 2) {
+      slot->rawlen--; // Remove trailing space
     }
   }
 };
@@ -1,6 +1,47 @@
 #include "IRremote.h"
 #include "IRremoteInt.h"
 
+//+=============================================================================
+// Header classes for decode()
+// The first mark of every protocol, MARK_EXCESS included, in uS:
+//   Denon 400, Mitsubishi 450, JVC repeat 700, Whynter 850, RC5 989,
+//   Sony 2500, RC6 2766, Panasonic/Sanyo 3602, Samsung 5100, JVC/LG 8100,
+//   Aiwa 8900, NEC 9100
+// A class starts at TICKS_LOW() of its shortest header. A protocol whose
+// TICKS_HIGH() reaches into the next class is listed in both.
+//
+#define CAND_NEC         0x0001
+#define CAND_SONY        0x0002
+#define CAND_SANYO       0x0004
+#define CAND_MITSUBISHI  0x0008
+#define CAND_RC5         0x0010
+#define CAND_RC6         0x0020
+#define CAND_PANASONIC   0x0040
+#define CAND_LG          0x0080
+#define CAND_JVC         0x0100
+#define CAND_SAMSUNG     0x0200
+#define CAND_WHYNTER     0x0400
+#define CAND_AIWA        0x0800
+#define CAND_DENON       0x1000
+#define CAND_LEGO_PF     0x2000
+#define CAND_ALL         0xFFFF
+
+#if DECODE_CLASSIFY
+static unsigned int  candidates (decode_results *results)
+{
+	if (results->rawlen < 2)  return 0 ;
+
+	int  mark = results->rawbuf[1];
+
+	if (mark < TICKS_LOW(2500))  return CAND_DENON | CAND_MITSUBISHI | CAND_JVC | CAND_WHYNTER | CAND_RC5 | CAND_LEGO_PF ;
+	if (mark < TICKS_LOW(5100))  return CAND_SONY | CAND_RC6 | CAND_PANASONIC | CAND_SANYO ;
+	if (mark < TICKS_LOW(8100))  return CAND_PANASONIC | CAND_SANYO | CAND_SAMSUNG ;
+	return CAND_SAMSUNG | CAND_NEC | CAND_JVC | CAND_LG | CAND_AIWA ;
+}
+#else
+#	define candidates(results)  CAND_ALL
+#endif
+
 //+=============================================================================
 // Decodes the received IR message
 // Returns 0 if no data ready, 1 if data ready.
@@ -8,81 +49,90 @@
 //
 int  IRrecv::decode (decode_results *results)
 {
-	results->rawbuf   = irparams.rawbuf;
-	results->rawlen   = irparams.rawlen;
+#ifdef IR_USE_EDGE
+	irEdgeTimeout();
+#endif
+	if (irparams.ready == 0)  return false ;
 
-	results->overflow = irparams.overflow;
+	// The slot stays ours until resume(); the ISR keeps recording into the others
+	volatile irslot_t  *slot = &irparams.slots[irparams.tail];
+	results->rawbuf   = slot->rawbuf;
+	results->rawlen   = slot->rawlen;
+	results->overflow = slot->overflow;
+	results->gap      = slot->gap;
 
-	if (irparams.rcvstate != STATE_STOP)  return false ;
+	// Pick the decoders once from the header instead of letting each rescan it
+	unsigned int  cand = candidates(results);
+	(void)cand;
 
 #if DECODE_NEC
 	DBG_PRINTLN("Attempting NEC decode");
-	if (decodeNEC(results))  return true ;
+	if ((cand & CAND_NEC) && decodeNEC(results))  return true ;
 #endif
 
 #if DECODE_SONY
 	DBG_PRINTLN("Attempting Sony decode");
-	if (decodeSony(results))  return true ;
+	if ((cand & CAND_SONY) && decodeSony(results))  return true ;
 #endif
 
 #if DECODE_SANYO
 	DBG_PRINTLN("Attempting Sanyo decode");
-	if (decodeSanyo(results))  return true ;
+	if ((cand & CAND_SANYO) && decodeSanyo(results))  return true ;
 #endif
 
 #if DECODE_MITSUBISHI
 	DBG_PRINTLN("Attempting Mitsubishi decode");
-	if (decodeMitsubishi(results))  return true ;
+	if ((cand & CAND_MITSUBISHI) && decodeMitsubishi(results))  return true ;
 #endif
 
 #if DECODE_RC5
 	DBG_PRINTLN("Attempting RC5 decode");
-	if (decodeRC5(results))  return true ;
+	if ((cand & CAND_RC5) && decodeRC5(results))  return true ;
 #endif
 
 #if DECODE_RC6
 	DBG_PRINTLN("Attempting RC6 decode");
-	if (decodeRC6(results))  return true ;
+	if ((cand & CAND_RC6) && decodeRC6(results))  return true ;
 #endif
 
 #if DECODE_PANASONIC
 	DBG_PRINTLN("Attempting Panasonic decode");
-	if (decodePanasonic(results))  return true ;
+	if ((cand & CAND_PANASONIC) && decodePanasonic(results))  return true ;
 #endif
 
 #if DECODE_LG
 	DBG_PRINTLN("Attempting LG decode");
-	if (decodeLG(results))  return true ;
+	if ((cand & CAND_LG) && decodeLG(results))  return true ;
 #endif
 
 #if DECODE_JVC
 	DBG_PRINTLN("Attempting JVC decode");
-	if (decodeJVC(results))  return true ;
+	if ((cand & CAND_JVC) && decodeJVC(results))  return true ;
 #endif
 
 #if DECODE_SAMSUNG
 	DBG_PRINTLN("Attempting SAMSUNG decode");
-	if (decodeSAMSUNG(results))  return true ;
+	if ((cand & CAND_SAMSUNG) && decodeSAMSUNG(results))  return true ;
 #endif
 
 #if DECODE_WHYNTER
 	DBG_PRINTLN("Attempting Whynter decode");
-	if (decodeWhynter(results))  return true ;
+	if ((cand & CAND_WHYNTER) && decodeWhynter(results))  return true ;
 #endif
 
 #if DECODE_AIWA_RC_T501
 	DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
-	if (decodeAiwaRCT501(results))  return true ;
+	if ((cand & CAND_AIWA) && decodeAiwaRCT501(results))  return true ;
 #endif
 
 #if DECODE_DENON
 	DBG_PRINTLN("Attempting Denon decode");
-	if (decodeDenon(results))  return true ;
+	if ((cand & CAND_DENON) && decodeDenon(results))  return true ;
 #endif
 
 #if DECODE_LEGO_PF
 	DBG_PRINTLN("Attempting Lego Power Functions");
-	if (decodeLegoPowerFunctions(results))  return true ;
+	if ((cand & CAND_LEGO_PF) && decodeLegoPowerFunctions(results))  return true ;
 #endif
 
 	// decodeHash returns a hash on any input.
@@ -135,13 +185,28 @@ void  IRrecv::enableIRIn ( )
 
 	// Initialize state machine variables
 	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+	irparams.head = irparams.tail = irparams.ready = 0;
 
 	// Set pin modes
 	pinMode(irparams.recvpin, INPUT);
 }
 #endif // USE_DEFAULT_ENABLE_IR_IN
 
+#ifdef IR_USE_EDGE
+void  IRrecv::enableIRIn ( )
+{
+	// Initialize state machine variables
+	irparams.rcvstate = STATE_IDLE;
+	irparams.head = irparams.tail = irparams.ready = 0;
+
+	// Set pin modes
+	pinMode(irparams.recvpin, INPUT);
+
+	irEdgeInit();
+	attachInterrupt(digitalPinToInterrupt(irparams.recvpin), irEdge, CHANGE);
+}
+#endif // IR_USE_EDGE
+
 //+=============================================================================
 // Enable/disable blinking of pin 13 on IR processing
 //
@@ -158,15 +223,28 @@ void  IRrecv::blink13 (int blinkflag)
 //
 bool  IRrecv::isIdle ( )
 {
+#ifdef IR_USE_EDGE
+	irEdgeTimeout();
+#endif
  return (irparams.rcvstate == STATE_IDLE || irparams.rcvstate == STATE_STOP) ? true : false;
 }
 //+=============================================================================
-// Restart the ISR state machine
+// Release the capture returned by decode() and restart the ISR if the ring was full
 //
 void  IRrecv::resume ( )
 {
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+	noInterrupts();
+	if (irparams.ready) {
+		irparams.ready--;
+		if (++irparams.tail >= RAWSLOTS)  irparams.tail = 0 ;
+	}
+	if (irparams.rcvstate == STATE_STOP) {
+		// The ring was full: the slot just released is the ISR's head, claim it
+		irparams.slots[irparams.head].rawlen   = 0;
+		irparams.slots[irparams.head].overflow = false;
+		irparams.rcvstate = STATE_IDLE;
+	}
+	interrupts();
 }
 
 //+=============================================================================
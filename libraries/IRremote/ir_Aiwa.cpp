@@ -77,14 +77,14 @@ bool  IRrecv::decodeAiwaRCT501 (decode_results *results)
 	int  offset = 1;
 
 	// Check SIZE
-	if (irparams.rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
+	if (results->rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
 
 	// Check HDR Mark/Space
 	if (!MATCH_MARK (results->rawbuf[offset++], AIWA_RC_T501_HDR_MARK ))  return false ;
 	if (!MATCH_SPACE(results->rawbuf[offset++], AIWA_RC_T501_HDR_SPACE))  return false ;
 
 	offset += 26;  // skip pre-data - optional
-	while(offset < irparams.rawlen - 4) {
+	while(offset < results->rawlen - 4) {
 		if (MATCH_MARK(results->rawbuf[offset], AIWA_RC_T501_BIT_MARK))  offset++ ;
 		else                                                             return false ;
 
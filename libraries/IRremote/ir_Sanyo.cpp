@@ -27,7 +27,7 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 	long  data   = 0;
 	int   offset = 0;  // Skip first space  <-- CHECK THIS!
 
-	if (irparams.rawlen < (2 * SANYO_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SANYO_BITS) + 2)  return false ;
 
 #if 0
 	// Put this back in for debugging - note can't use #DEBUG as if Debug on we don't see the repeat cos of the delay
@@ -38,7 +38,7 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 #endif
 
 	// Initial space
-	if (results->rawbuf[offset] < SANYO_DOUBLE_SPACE_USECS) {
+	if (results->gap < SANYO_DOUBLE_SPACE_USECS) {
 		//Serial.print("IR Gap found: ");
 		results->bits        = 0;
 		results->value       = REPEAT;
@@ -53,7 +53,7 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 	// Skip Second Mark
 	if (!MATCH_MARK(results->rawbuf[offset++], SANYO_HDR_MARK))  return false ;
 
-	while (offset + 1 < irparams.rawlen) {
+	while (offset + 1 < results->rawlen) {
 		if (!MATCH_SPACE(results->rawbuf[offset++], SANYO_HDR_SPACE))  break ;
 
 		if      (MATCH_MARK(results->rawbuf[offset], SANYO_ONE_MARK))   data = (data << 1) | 1 ;
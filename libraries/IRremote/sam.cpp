@@ -80,7 +80,7 @@ void IRrecv::enableIRIn()
 
 	// Initialize state machine variables
 	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+	irparams.head = irparams.tail = irparams.ready = 0;
 
 	// Set pin modes
 	pinMode(irparams.recvpin, INPUT);